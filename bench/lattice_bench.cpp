@@ -0,0 +1,403 @@
+// lattice_bench times the ring operations at every parameter set and thread count and prints the results as JSON,
+// so that two releases can be compared with a plain diff or a script.
+//
+// Usage: lattice_bench [--filter=TEXT] [--degrees=256,512,1024] [--threads=1,N] [--min-time=SECONDS] [--out=FILE]
+//
+// Each benchmark runs on a team of threads that all execute the same operation. Iterations grow until a run lasts at
+// least --min-time; only that last run is reported:
+//   ns_per_op               wall time of the run divided by the iterations of one thread (latency under that load)
+//   ops_per_second          operations completed by the whole team per second
+//   bytes_allocated_per_op  bytes requested from operator new per operation (Eigen and OpenSSL call malloc directly
+//                           and are not counted)
+//   allocations_per_op      calls to operator new per operation
+//   cycles_per_coefficient  time-stamp counter ticks per operation and coefficient, null where there is no counter
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "lattice_crypto.h"
+#include "ntt_kernels.h"
+#include "serialization.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LATTICE_BENCH_HAS_TSC 1
+#endif
+
+using namespace lattice_crypto;
+
+// Every C++ heap allocation in this process goes through the replacements below and is counted
+static std::atomic<uint64_t> allocated_bytes{0};
+static std::atomic<uint64_t> allocation_count{0};
+
+void* operator new(std::size_t size) {
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+// Kept out of line: GCC otherwise pairs the inlined free with operator new and warns about a mismatch
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Reads the time-stamp counter, or 0 where there is none
+uint64_t ticks() {
+#ifdef LATTICE_BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Builds the operation one thread runs; called on that thread, so per-thread state is set up where it is used
+using OperationFactory = std::function<std::function<void()>()>;
+
+// One registered benchmark at one parameter set
+struct Benchmark {
+    std::string operation;  // Operation name, e.g. "encrypt"
+    int n;  // Ring degree
+    int q;  // Modulus
+    OperationFactory factory;  // Per-thread operation
+};
+
+// Totals of one timed run across the team
+struct Sample {
+    uint64_t iterations;  // Iterations of each thread
+    double seconds;  // Wall time from start to the last thread finishing
+    uint64_t ticks;  // Time-stamp counter ticks over the same interval
+    uint64_t bytes;  // Bytes requested from operator new
+    uint64_t allocations;  // Calls to operator new
+};
+
+// Team keeps a set of threads alive across the calibration runs of one benchmark, so thread-local workspaces and
+// samplers are warm and thread start-up is never timed
+class Team {
+public:
+    Team(size_t threads, const OperationFactory& factory) {
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this, &factory] { work(factory); });
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return ready == workers.size(); });
+        if (failure) {
+            lock.unlock();
+            stop();
+            std::rethrow_exception(failure);
+        }
+    }
+
+    ~Team() { stop(); }
+
+    Team(const Team&) = delete;
+    Team& operator=(const Team&) = delete;
+
+    // Runs iterations of the operation on every thread at once
+    Sample run(uint64_t iterations) {
+        Sample sample{iterations, 0.0, 0, 0, 0};
+        std::unique_lock<std::mutex> lock(mutex);
+        const uint64_t bytes = allocated_bytes.load();
+        const uint64_t count = allocation_count.load();
+        const uint64_t tsc = ticks();
+        const auto start = std::chrono::steady_clock::now();
+        round_iterations = iterations;
+        finished = 0;
+        ++round;
+        changed.notify_all();
+        changed.wait(lock, [&] { return finished == workers.size(); });
+        sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sample.ticks = ticks() - tsc;
+        sample.bytes = allocated_bytes.load() - bytes;
+        sample.allocations = allocation_count.load() - count;
+        if (failure) std::rethrow_exception(failure);
+        return sample;
+    }
+
+private:
+    // Worker loop: build the operation, run it once to warm up, then run each round as it is posted
+    void work(const OperationFactory& factory) {
+        std::function<void()> operation;
+        try {
+            operation = factory();
+            operation();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failure) failure = std::current_exception();
+        }
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        ++ready;
+        changed.notify_all();
+        while (true) {
+            changed.wait(lock, [&] { return stopping || round != seen; });
+            if (stopping) return;
+            seen = round;
+            const uint64_t iterations = round_iterations;
+            lock.unlock();
+            try {
+                if (operation) {
+                    for (uint64_t i = 0; i < iterations; ++i) operation();
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> failed(mutex);
+                if (!failure) failure = std::current_exception();
+            }
+            lock.lock();
+            ++finished;
+            changed.notify_all();
+        }
+    }
+
+    // Joins every worker
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        for (std::thread& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    std::vector<std::thread> workers;  // Team members
+    std::mutex mutex;  // Guards everything below
+    std::condition_variable changed;  // Signals a new round, a finished worker or shutdown
+    size_t ready = 0;  // Workers that have built their operation
+    size_t finished = 0;  // Workers done with the current round
+    uint64_t round = 0;  // Round counter; a change starts a round
+    uint64_t round_iterations = 0;  // Iterations per worker in the current round
+    bool stopping = false;  // Set once by stop
+    std::exception_ptr failure;  // First exception thrown by an operation
+};
+
+// Runs a benchmark with growing iteration counts until one run lasts min_time, and returns that run
+Sample measure(const Benchmark& benchmark, size_t threads, double min_time) {
+    Team team(threads, benchmark.factory);
+    uint64_t iterations = 1;
+    while (true) {
+        Sample sample = team.run(iterations);
+        if (sample.seconds >= min_time || iterations >= 1000000000) return sample;
+        // Aim 40% past the target, growing at most tenfold per step, as Google Benchmark does
+        double scale = sample.seconds > 0.0 ? 1.4 * min_time / sample.seconds : 10.0;
+        scale = std::min(10.0, std::max(scale, 1.0));
+        iterations = std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) * scale));
+    }
+}
+
+// Plaintext filling the whole capacity of one ciphertext
+std::string full_message(RingLWECrypto& crypto) { return std::string(crypto.max_plaintext_size(), 'w'); }
+
+// Registers every operation at one parameter set; crypto is shared by the threads, like a wallet process shares its keys
+void add_benchmarks(std::vector<Benchmark>& benchmarks, int n, int q) {
+    auto crypto = std::make_shared<RingLWECrypto>(n, q);
+    auto add = [&](const std::string& operation, OperationFactory factory) {
+        benchmarks.push_back(Benchmark{operation, n, q, std::move(factory)});
+    };
+
+    add("ntt_forward", [crypto, n, q] {
+        auto values = std::make_shared<RingElement>(KeyGenerator().generate_uniform_polynomial(n, q));
+        return [crypto, values] { crypto->plan().forward(values->data()); };
+    });
+    add("ntt_inverse", [crypto, n, q] {
+        auto values = std::make_shared<RingElement>(KeyGenerator().generate_uniform_polynomial(n, q));
+        return [crypto, values] { crypto->plan().inverse(values->data()); };
+    });
+    add("polynomial_multiply", [crypto, n, q] {
+        auto generator = std::make_shared<KeyGenerator>();
+        auto a = std::make_shared<RingElement>(generator->generate_uniform_polynomial(n, q));
+        auto b = std::make_shared<RingElement>(generator->generate_random_polynomial(n));
+        return [generator, a, b, q] { generator->polynomial_multiply(*a, *b, q); };
+    });
+    add("generate_random_matrix", [n] {
+        auto generator = std::make_shared<KeyGenerator>();
+        return [generator, n] { generator->generate_random_matrix(1, n); };
+    });
+    add("generate_binomial_error", [n] {
+        auto generator = std::make_shared<KeyGenerator>();
+        return [generator, n] { generator->generate_binomial_error(1, n); };
+    });
+    add("generate_error_polynomial", [n, q] {
+        auto generator = std::make_shared<KeyGenerator>();
+        return [generator, n, q] { generator->generate_error_polynomial(n, q); };
+    });
+    add("keygen", [n, q] {
+        return [n, q] { RingLWECrypto fresh(n, q); };
+    });
+    add("encrypt", [crypto] {
+        auto message = std::make_shared<std::string>(full_message(*crypto));
+        return [crypto, message] { crypto->encrypt(*message); };
+    });
+    add("encrypt_into", [crypto] {
+        auto message = std::make_shared<std::string>(full_message(*crypto));
+        auto out = std::make_shared<Ciphertext>();
+        return [crypto, message, out] { crypto->encrypt_into(*message, *out); };
+    });
+    add("decrypt", [crypto] {
+        auto ciphertext = std::make_shared<Ciphertext>(crypto->encrypt(full_message(*crypto)));
+        return [crypto, ciphertext] { crypto->decrypt_bytes(*ciphertext); };
+    });
+    add("decrypt_into", [crypto] {
+        auto ciphertext = std::make_shared<Ciphertext>(crypto->encrypt(full_message(*crypto)));
+        auto out = std::make_shared<std::string>();
+        return [crypto, ciphertext, out] { crypto->decrypt_into(*ciphertext, *out); };
+    });
+    add("serialize", [crypto] {
+        auto ciphertext = std::make_shared<Ciphertext>(crypto->encrypt(full_message(*crypto)));
+        return [crypto, ciphertext] { crypto->to_bytes(*ciphertext); };
+    });
+    add("deserialize", [crypto] {
+        auto bytes = std::make_shared<std::string>(crypto->to_bytes(crypto->encrypt(full_message(*crypto))));
+        return [crypto, bytes] { crypto->ciphertext_from_bytes(*bytes); };
+    });
+}
+
+// Parses a comma-separated list of positive integers
+std::vector<int> parse_list(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int value = std::stoi(item);
+        if (value <= 0) throw std::invalid_argument("List values must be positive: " + text);
+        values.push_back(value);
+    }
+    return values;
+}
+
+// Modulus of the parameter set for a ring degree
+int modulus_for(int n) {
+    switch (n) {
+        case 256: return 7681;
+        case 512: return 12289;
+        case 1024: return 12289;
+        default: throw std::invalid_argument("No parameter set for degree " + std::to_string(n));
+    }
+}
+
+// Escapes a string for a JSON literal; the names written here never need more than quotes and backslashes
+std::string json_string(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+int main(int argc, char** argv) {
+    std::string filter, out_path;
+    std::vector<int> degrees = {256, 512, 1024};
+    std::vector<int> thread_counts = {1};
+    const int hardware = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (hardware > 1) thread_counts.push_back(hardware);
+    double min_time = 0.2;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&](const std::string& flag) { return arg.substr(flag.size()); };
+            if (arg.rfind("--filter=", 0) == 0) filter = value("--filter=");
+            else if (arg.rfind("--degrees=", 0) == 0) degrees = parse_list(value("--degrees="));
+            else if (arg.rfind("--threads=", 0) == 0) thread_counts = parse_list(value("--threads="));
+            else if (arg.rfind("--min-time=", 0) == 0) min_time = std::stod(value("--min-time="));
+            else if (arg.rfind("--out=", 0) == 0) out_path = value("--out=");
+            else throw std::invalid_argument("Unknown argument: " + arg);
+        }
+        for (int n : degrees) modulus_for(n);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Usage: " << argv[0]
+                  << " [--filter=TEXT] [--degrees=256,512,1024] [--threads=1,N] [--min-time=SECONDS] [--out=FILE]" << std::endl;
+        return 2;
+    }
+
+    std::vector<Benchmark> benchmarks;
+    for (int n : degrees) add_benchmarks(benchmarks, n, modulus_for(n));
+
+    std::ostringstream json;
+    json << std::setprecision(6);
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    json << "{\n  \"context\": {\n";
+    json << "    \"date\": " << json_string(date) << ",\n";
+    json << "    \"hardware_threads\": " << hardware << ",\n";
+    json << "    \"kernels\": " << json_string(active_kernels().name) << ",\n";
+#ifdef NDEBUG
+    json << "    \"build\": \"release\",\n";
+#else
+    json << "    \"build\": \"debug\",\n";
+#endif
+    json << "    \"min_time\": " << min_time << "\n  },\n  \"benchmarks\": [";
+
+    bool first = true;
+    for (const Benchmark& benchmark : benchmarks) {
+        for (int threads : thread_counts) {
+            const std::string name = benchmark.operation + "/n:" + std::to_string(benchmark.n) + "/threads:" + std::to_string(threads);
+            if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+            Sample sample = measure(benchmark, threads, min_time);
+            const double operations = static_cast<double>(sample.iterations) * threads;
+            std::cerr << name << ": " << sample.seconds * 1e9 / sample.iterations << " ns/op" << std::endl;
+
+            json << (first ? "\n" : ",\n") << "    {\n";
+            json << "      \"name\": " << json_string(name) << ",\n";
+            json << "      \"operation\": " << json_string(benchmark.operation) << ",\n";
+            json << "      \"poly_degree\": " << benchmark.n << ",\n";
+            json << "      \"modulus\": " << benchmark.q << ",\n";
+            json << "      \"threads\": " << threads << ",\n";
+            json << "      \"iterations\": " << sample.iterations << ",\n";
+            json << "      \"ns_per_op\": " << sample.seconds * 1e9 / sample.iterations << ",\n";
+            json << "      \"ops_per_second\": " << operations / sample.seconds << ",\n";
+            json << "      \"bytes_allocated_per_op\": " << sample.bytes / operations << ",\n";
+            json << "      \"allocations_per_op\": " << sample.allocations / operations << ",\n";
+            json << "      \"cycles_per_coefficient\": ";
+#ifdef LATTICE_BENCH_HAS_TSC
+            json << static_cast<double>(sample.ticks) / sample.iterations / benchmark.n << "\n";
+#else
+            json << "null\n";
+#endif
+            json << "    }";
+            first = false;
+        }
+    }
+    json << "\n  ]\n}\n";
+
+    if (out_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(out_path);
+        file << json.str();
+        if (!file) {
+            std::cerr << "Could not write " << out_path << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// creed_cryptod loads the wallet's lattice keys once and serves encryption and decryption to every local process over
+// a Unix domain socket, in the protocol of cryptod_protocol.h. Python code talks to it through src/cryptod_client.py.
+//
+// Usage: creed_cryptod [--keystore=PATH] [--socket=PATH] [--workers=N] [--pool-depth=N] [--log=PATH]
+//
+//   --keystore    keystore written by save_keystore; generated (512, 12289) when missing. Default keys/lattice.keystore
+//   --socket      listening socket. Default creed_cryptod.sock in $XDG_RUNTIME_DIR, or in a private /tmp/creed-<uid>
+//   --workers     threads running the crypto. Default one per hardware thread
+//   --pool-depth  encryptions kept precomputed by a randomness pool. Default 0, no pool
+//   --log         log file. Default logs/crypto_log.txt
+//
+// SIGINT and SIGTERM stop the daemon after the requests it has read are answered.
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include "crypto_log.h"
+#include "cryptod_server.h"
+#include "lattice_crypto.h"
+#include "randomness_pool.h"
+
+using namespace lattice_crypto;
+
+// Server to stop from the signal handler
+static CryptodServer* running_server = nullptr;
+
+extern "C" void handle_stop_signal(int) {
+    if (running_server) running_server->stop();
+}
+
+// Maps the keystore, or generates keys and writes one readable only by this user
+RingLWECrypto load_keys(const std::string& path) {
+    struct stat existing;
+    if (::stat(path.c_str(), &existing) == 0) return RingLWECrypto::from_keystore(path);
+    RingLWECrypto crypto(512, 12289);
+    const size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos && slash > 0) ::mkdir(path.substr(0, slash).c_str(), 0700);
+    const mode_t previous = ::umask(077);
+    crypto.save_keystore(path);
+    ::umask(previous);
+    CRYPTO_LOG(info) << "Generated lattice keystore at " << path;
+    return RingLWECrypto::from_keystore(path);
+}
+
+int main(int argc, char** argv) {
+    std::string keystore = "keys/lattice.keystore", log_path;
+    CryptodServerOptions options;
+    size_t pool_depth = 0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&](const std::string& flag) { return arg.substr(flag.size()); };
+            if (arg.rfind("--keystore=", 0) == 0) keystore = value("--keystore=");
+            else if (arg.rfind("--socket=", 0) == 0) options.socket_path = value("--socket=");
+            else if (arg.rfind("--workers=", 0) == 0) options.workers = std::stoul(value("--workers="));
+            else if (arg.rfind("--pool-depth=", 0) == 0) pool_depth = std::stoul(value("--pool-depth="));
+            else if (arg.rfind("--log=", 0) == 0) log_path = value("--log=");
+            else throw std::invalid_argument("Unknown argument: " + arg);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Usage: " << argv[0]
+                  << " [--keystore=PATH] [--socket=PATH] [--workers=N] [--pool-depth=N] [--log=PATH]" << std::endl;
+        return 2;
+    }
+
+    try {
+        if (log_path.empty()) init_logging();
+        else open_log(log_path);
+
+        RingLWECrypto crypto = load_keys(keystore);
+        if (pool_depth > 0) {
+            RandomnessPoolOptions pool;
+            pool.depth = pool_depth;
+            pool.refill_below = pool_depth / 2 > 0 ? pool_depth / 2 : 1;
+            crypto.enable_randomness_pool(pool);
+        }
+
+        CryptodServer server(crypto, options);
+        running_server = &server;
+        struct sigaction action {};
+        action.sa_handler = handle_stop_signal;
+        sigemptyset(&action.sa_mask);
+        ::sigaction(SIGINT, &action, nullptr);
+        ::sigaction(SIGTERM, &action, nullptr);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        std::cerr << "creed_cryptod serving " << crypto.engine().name() << " on " << server.socket_path() << std::endl;
+        server.run();
+        running_server = nullptr;
+    } catch (const std::exception& e) {
+        std::cerr << "creed_cryptod: " << e.what() << std::endl;
+        CRYPTO_LOG(error) << "creed_cryptod failed: " << e.what();
+        close_log();
+        return 1;
+    }
+    close_log();
+    return 0;
+}
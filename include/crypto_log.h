@@ -0,0 +1,102 @@
+#ifndef CRYPTO_LOG_H
+#define CRYPTO_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Lowest level compiled into the library: 0 trace, 1 debug, 2 info, 3 warn, 4 error.
+// Release builds drop trace calls entirely; override with -DLATTICE_CRYPTO_MIN_LOG_LEVEL=n.
+#ifndef LATTICE_CRYPTO_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define LATTICE_CRYPTO_MIN_LOG_LEVEL 1
+#else
+#define LATTICE_CRYPTO_MIN_LOG_LEVEL 0
+#endif
+#endif
+
+// Streams one log record at the given level, e.g. CRYPTO_LOG(debug) << "n: " << n;
+// Below the compile-time level the whole statement, operands included, is dead code; below the
+// runtime level or with no log open, the operands are not evaluated.
+#define CRYPTO_LOG(level)                                                                                \
+    if (static_cast<int>(::lattice_crypto::LogLevel::level) < LATTICE_CRYPTO_MIN_LOG_LEVEL ||            \
+        !::lattice_crypto::log_enabled(::lattice_crypto::LogLevel::level)) {                             \
+    } else                                                                                               \
+        ::lattice_crypto::LogRecord(::lattice_crypto::LogLevel::level)
+
+namespace lattice_crypto {
+
+class RingElement;
+class RingKey;
+
+// Severity of a log record
+enum class LogLevel : int { trace = 0, debug = 1, info = 2, warn = 3, error = 4, off = 5 };
+
+// Longest message kept per record; longer ones are truncated
+constexpr size_t kLogMessageBytes = 240;
+
+// Opens (appending) the log file and starts the background writer; replaces any log already open
+void open_log(const std::string& path);
+
+// Creates the logs directory and opens logs/crypto_log.txt
+void init_logging();
+
+// Drains the queue, stops the writer and closes the file
+void close_log();
+
+// Blocks until every record queued so far has been written and flushed
+void flush_log();
+
+// Sets the lowest level recorded at runtime; levels below LATTICE_CRYPTO_MIN_LOG_LEVEL stay compiled out
+void set_log_level(LogLevel level);
+
+// Lowest level recorded at runtime
+LogLevel log_level();
+
+// True when a record at this level would be written
+bool log_enabled(LogLevel level);
+
+// Records dropped because the queue was full
+uint64_t dropped_log_records();
+
+// LogRecord formats one message into a fixed buffer on the caller's stack and queues it when
+// destroyed. Formatting never allocates and nothing touches the file on the calling thread.
+// Only strings and numbers can be streamed: ring elements and keys print as a redacted
+// placeholder, and any other type fails to compile, so key material cannot reach the log.
+class LogRecord {
+public:
+    explicit LogRecord(LogLevel level) : level(level) {}
+    ~LogRecord();
+
+    LogRecord(const LogRecord&) = delete;
+    LogRecord& operator=(const LogRecord&) = delete;
+
+    LogRecord& operator<<(const char* text);
+    LogRecord& operator<<(const std::string& text);
+    LogRecord& operator<<(char c);
+    LogRecord& operator<<(bool value);
+    LogRecord& operator<<(double value);
+    LogRecord& operator<<(const RingElement& element);
+    LogRecord& operator<<(const RingKey& key);
+
+    template <class T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                                   !std::is_same<T, char>::value, int>::type = 0>
+    LogRecord& operator<<(T value) {
+        return std::is_signed<T>::value ? append_signed(static_cast<long long>(value))
+                                        : append_unsigned(static_cast<unsigned long long>(value));
+    }
+
+private:
+    LogRecord& append(const char* data, size_t size);
+    LogRecord& append_signed(long long value);
+    LogRecord& append_unsigned(unsigned long long value);
+
+    LogLevel level;  // Severity
+    size_t length = 0;  // Bytes used in text
+    char text[kLogMessageBytes];  // Message being built
+};
+
+}  // namespace lattice_crypto
+
+#endif  // CRYPTO_LOG_H
@@ -0,0 +1,86 @@
+#ifndef CRYPTOD_PROTOCOL_H
+#define CRYPTOD_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lattice_crypto {
+
+// Wire protocol of creed_cryptod. Requests and responses share one frame layout, all integers little-endian:
+//
+//   offset  size  field
+//   0       4     frame length: bytes after this field, at least 5
+//   4       4     request id, chosen by the client and echoed in the response
+//   8       1     opcode in a request, status in a response
+//   9       ...   payload
+//
+// A client may write any number of requests before reading; responses on one connection come back in request order.
+// Batch payloads are a 4-byte item count followed by each item as a 4-byte length and its bytes. Ciphertexts travel
+// in the serialization.h format (RingLWECrypto::to_bytes) and decrypt like decrypt_bytes, which ends the plaintext at
+// its first 0x00 or 0xff byte; the daemon therefore rejects plaintexts holding either byte instead of returning them
+// cut short. Binary data goes through hybrid_encrypt or EncryptStream. An error response carries a message as its
+// payload. A frame length outside [5, max frame] cannot be resynchronized, so the daemon closes the connection instead.
+// A batch whose answer could exceed the frame limit, counting each item at its largest answer, is refused as a whole.
+
+// What a request asks for
+enum class CryptodOpcode : uint8_t {
+    ping = 0,  // Empty payload; answered with an empty payload
+    public_key = 1,  // Empty payload; answered with public_key_bytes()
+    encrypt = 2,  // Plaintext without 0x00 or 0xff bytes; answered with one ciphertext
+    decrypt = 3,  // One ciphertext; answered with the plaintext bytes
+    encrypt_batch = 4,  // Batch of plaintexts; answered with a batch of ciphertexts
+    decrypt_batch = 5,  // Batch of ciphertexts; answered with a batch of plaintexts
+    metrics = 6,  // Empty payload; answered with the daemon's metrics in the Prometheus text format
+};
+
+// How a request ended
+enum class CryptodStatus : uint8_t {
+    ok = 0,  // Payload is the result
+    bad_request = 1,  // Unknown opcode, malformed payload, oversized or binary plaintext, or foreign ciphertext
+    failed = 2,  // The daemon could not complete a valid request
+};
+
+// Bytes of a frame before its payload
+constexpr size_t kCryptodHeaderBytes = 9;
+
+// Default upper bound on a frame, header included
+constexpr size_t kCryptodMaxFrameBytes = size_t(64) << 20;
+
+// One parsed frame; the payload points into the buffer it was parsed from
+struct CryptodFrame {
+    uint32_t id = 0;  // Request id
+    uint8_t code = 0;  // Opcode or status
+    std::string_view payload;  // Bytes after the header
+};
+
+// Appends the header of a frame whose payload of payload_size bytes the caller appends next; throws
+// std::invalid_argument when the frame length would not fit its 32-bit field
+void append_cryptod_header(std::string& out, uint32_t id, uint8_t code, size_t payload_size);
+
+// Appends a whole frame
+void append_cryptod_frame(std::string& out, uint32_t id, uint8_t code, std::string_view payload);
+
+// Parses the frame at the start of data; returns the bytes it spans, or 0 when data does not yet hold all of it.
+// Throws std::invalid_argument when the length field is outside [5, max_frame_bytes - 4].
+size_t parse_cryptod_frame(std::string_view data, CryptodFrame& frame, size_t max_frame_bytes = kCryptodMaxFrameBytes);
+
+// Bytes of a batch payload holding these items
+size_t cryptod_batch_size(const std::vector<std::string>& items);
+
+// Appends a batch payload
+void append_cryptod_batch(std::string& out, const std::vector<std::string>& items);
+
+// Splits a batch payload into views of its items; throws std::invalid_argument when it is malformed
+std::vector<std::string_view> parse_cryptod_batch(std::string_view payload);
+
+// Socket path used when none is given: creed_cryptod.sock in $XDG_RUNTIME_DIR or, without one, in /tmp/creed-<euid>.
+// That directory is created with mode 0700 when missing; throws std::runtime_error when it cannot be created or is
+// not a directory owned by this user and closed to everyone else.
+std::string default_cryptod_socket_path();
+
+}  // namespace lattice_crypto
+
+#endif  // CRYPTOD_PROTOCOL_H
@@ -0,0 +1,130 @@
+#ifndef CRYPTOD_SERVER_H
+#define CRYPTOD_SERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "cryptod_protocol.h"
+#include "thread_pool.h"
+
+namespace lattice_crypto {
+
+class RingLWECrypto;
+
+// How a CryptodServer listens and how much work it takes on
+struct CryptodServerOptions {
+    std::string socket_path;  // Filesystem path of the listening socket; empty picks default_cryptod_socket_path()
+    size_t workers = 0;  // Worker threads running the crypto; 0 starts one per hardware thread
+    size_t max_frame_bytes = kCryptodMaxFrameBytes;  // Longer frames close the connection
+    size_t max_pending = 1024;  // Unanswered requests per connection before the daemon stops reading from it
+    unsigned socket_mode = 0600;  // Permissions of the socket file
+};
+
+// Totals since the server started
+struct CryptodServerStats {
+    uint64_t connections = 0;  // Connections accepted
+    uint64_t requests = 0;  // Requests answered
+    uint64_t batches = 0;  // Rounds of work handed to the workers
+};
+
+// CryptodServer answers the protocol of cryptod_protocol.h on a Unix domain socket, with one set of keys shared by
+// every client. A single thread runs an epoll loop over non-blocking sockets: it reads whatever each client has sent,
+// splits it into frames and queues them. A dispatcher thread takes everything queued since its last round as one
+// batch and spreads the items, including those inside batch requests, over the worker pool. While a round runs,
+// new requests pile up for the next one, so batches grow with the load. Finished rounds go back to the loop through
+// an eventfd and are written out in request order.
+//
+// Only the user running the server, and root, may connect: the socket file gets socket_mode, and each peer's
+// credentials are checked on accept.
+class CryptodServer {
+public:
+    // Binds and listens; a stale socket file left by a dead server is replaced. Throws std::runtime_error when the
+    // path is in use by a live server, is not a socket, or cannot be bound.
+    CryptodServer(RingLWECrypto& crypto, const CryptodServerOptions& options = {});
+
+    // Closes every connection and removes the socket file
+    ~CryptodServer();
+
+    CryptodServer(const CryptodServer&) = delete;
+    CryptodServer& operator=(const CryptodServer&) = delete;
+
+    // Serves until stop() is called. Requests already read are finished before it returns, and their responses are
+    // written as far as each client's socket takes them. Call it once, from one thread.
+    void run();
+
+    // Makes run() return; async-signal-safe, so a SIGTERM handler may call it
+    void stop();
+
+    // Path of the listening socket
+    const std::string& socket_path() const { return path; }
+
+    // Totals so far; safe to call from any thread
+    CryptodServerStats stats() const;
+
+private:
+    struct Connection;  // Socket and buffers of one client
+    struct Job;  // One request and its response
+    using JobList = std::vector<std::shared_ptr<Job>>;
+
+    // Accepts every waiting connection
+    void accept_connections();
+
+    // Reads what the client has sent and queues its complete frames
+    void read_connection(const std::shared_ptr<Connection>& connection);
+
+    // Queues the complete frames in the connection's input buffer, up to max_pending
+    void parse_frames(const std::shared_ptr<Connection>& connection);
+
+    // Moves answered requests into the output buffer, in order, and writes as much as the socket takes
+    void flush_connection(const std::shared_ptr<Connection>& connection);
+
+    // Registers the events the connection currently needs; closes it once it has nothing left to do
+    void update_connection(const std::shared_ptr<Connection>& connection);
+
+    // Removes the connection from the loop and closes its socket
+    void close_connection(const std::shared_ptr<Connection>& connection);
+
+    // Takes the finished rounds from the dispatcher and flushes the connections they belong to
+    void collect_completed();
+
+    // Dispatcher thread: runs each round of queued jobs on the workers
+    void dispatch();
+
+    // Computes the response of every job in a round
+    void process(JobList& round);
+
+    // Appends the response frame of a finished job
+    static void append_response(std::string& out, const Job& job);
+
+    RingLWECrypto& crypto;  // Keys shared by every request
+    CryptodServerOptions options;  // Limits and paths
+    std::string path;  // Listening socket path
+    uint64_t socket_inode = 0;  // Inode of the socket file, so the destructor never removes another server's socket
+    int listen_fd = -1;  // Listening socket
+    int epoll_fd = -1;  // Event loop
+    int wake_fd = -1;  // eventfd signalled by stop() and by finished rounds
+    std::unique_ptr<ThreadPool> workers;  // Threads running the crypto
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;  // Open connections by socket; loop thread only
+    JobList parsed;  // Jobs read in the current loop iteration; loop thread only
+
+    std::mutex queue_mutex;  // Guards queued, completed and dispatcher_stopping
+    std::condition_variable queue_ready;  // Wakes the dispatcher
+    JobList queued;  // Jobs waiting for the next round
+    JobList completed;  // Jobs whose responses are ready
+    bool dispatcher_stopping = false;  // Set when run() is about to return
+
+    std::atomic<bool> stopping{false};  // Set by stop()
+    std::atomic<uint64_t> connection_count{0};  // Connections accepted
+    std::atomic<uint64_t> request_count{0};  // Requests answered
+    std::atomic<uint64_t> batch_count{0};  // Rounds run
+};
+
+}  // namespace lattice_crypto
+
+#endif  // CRYPTOD_SERVER_H
@@ -0,0 +1,35 @@
+#ifndef EIGEN_INTEROP_H
+#define EIGEN_INTEROP_H
+
+#include <Eigen/Dense>
+#include "polynomial.h"
+
+namespace lattice_crypto {
+
+// Compatibility shims for callers that still hold ring elements as Eigen matrices.
+// New code should use RingElement directly.
+
+// Reads the ring element of a matrix (row 0 of a row vector, column 0 otherwise) and reduces it into [0, q)
+inline RingElement from_eigen(const Eigen::MatrixXi& matrix, int q) {
+    const bool is_row = matrix.rows() == 1;
+    const Eigen::Index n = is_row ? matrix.cols() : matrix.rows();
+    RingElement element(static_cast<std::size_t>(n));
+    for (Eigen::Index i = 0; i < n; ++i) {
+        int x = (is_row ? matrix(0, i) : matrix(i, 0)) % q;
+        element[static_cast<std::size_t>(i)] = x < 0 ? x + q : x;
+    }
+    return element;
+}
+
+// Returns the ring element as a 1 x n row vector
+inline Eigen::MatrixXi to_eigen(const RingElement& element) {
+    Eigen::MatrixXi matrix(1, static_cast<Eigen::Index>(element.size()));
+    for (std::size_t i = 0; i < element.size(); ++i) {
+        matrix(0, static_cast<Eigen::Index>(i)) = element[i];
+    }
+    return matrix;
+}
+
+}  // namespace lattice_crypto
+
+#endif  // EIGEN_INTEROP_H
@@ -0,0 +1,53 @@
+#ifndef HYBRID_H
+#define HYBRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace lattice_crypto {
+
+class RingLWECrypto;
+
+// Hybrid encryption for payloads of any size: every message gets a fresh 32-byte AES-256-GCM key, which is
+// encapsulated with the Ring-LWE keys, and the payload itself is encrypted with AES-GCM through OpenSSL EVP
+// (AES-NI and carry-less multiply where the CPU has them). The lattice work is one encryption per message
+// whatever the payload size.
+//
+// Sealed message layout:
+//
+//   offset  size  field
+//   0       4     magic "CRHY"
+//   4       1     format version (kHybridVersion)
+//   5       3     reserved, zero
+//   8       4     capsule length, little-endian
+//   12      ...   capsule: the session key encrypted as a Ring-LWE ciphertext, in the serialization.h format
+//   ...     12    GCM nonce
+//   ...     ...   AES-256-GCM ciphertext, as long as the plaintext
+//   ...     16    GCM tag
+//
+// The header and the capsule are authenticated along with the caller's associated data, so a capsule cannot be
+// moved onto another payload.
+
+// Current sealed message version; readers reject any other
+constexpr uint8_t kHybridVersion = 1;
+
+// Session key, nonce and tag sizes
+constexpr size_t kHybridKeyBytes = 32;
+constexpr size_t kHybridNonceBytes = 12;
+constexpr size_t kHybridTagBytes = 16;
+
+// Bytes a sealed message adds to its plaintext for the given keys
+size_t hybrid_overhead(const RingLWECrypto& crypto);
+
+// Encrypts plaintext of any length; associated_data is authenticated but not encrypted or included
+std::string hybrid_encrypt(RingLWECrypto& crypto, std::string_view plaintext, std::string_view associated_data = {});
+
+// Decrypts a message sealed by hybrid_encrypt with the same associated data. Throws std::invalid_argument when the
+// message is malformed, was made for other parameters, or fails authentication.
+std::string hybrid_decrypt(RingLWECrypto& crypto, std::string_view sealed, std::string_view associated_data = {});
+
+}  // namespace lattice_crypto
+
+#endif  // HYBRID_H
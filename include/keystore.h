@@ -0,0 +1,79 @@
+#ifndef KEYSTORE_H
+#define KEYSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include "ring_key.h"
+
+namespace lattice_crypto {
+
+class RingLWEEngine;
+
+// Keystore file layout, all integers in host byte order (the marker field rejects files from the other endianness):
+//
+//   offset  size  field
+//   0       4     magic "CRKS"
+//   4       4     format version (kKeystoreVersion)
+//   8       4     byte-order marker 0x01020304
+//   12      4     ring degree n
+//   16      4     modulus q
+//   20      4     flags, bit 0 set when the secret key is present
+//   24      40    reserved, zero
+//   64      ...   int32 arrays a, NTT(a), b, NTT(b) and, with the secret key, s, NTT(s),
+//                 each n entries starting on a 64-byte boundary
+//
+// Loading maps the file read-only and points the keys straight into the mapping, so nothing is copied at startup
+// and every process that maps the file, including pre-forked workers, shares the same pages. Each key is transformed
+// once on load to check that its two forms agree.
+
+// Current keystore version; readers reject any other
+constexpr uint32_t kKeystoreVersion = 1;
+
+// Bytes before the first key array
+constexpr size_t kKeystoreHeaderBytes = 64;
+
+// MappedFile is a read-only, shared memory mapping of a whole file; the mapping is released on destruction
+class MappedFile {
+public:
+    // Maps the file; throws std::runtime_error when it cannot be opened or mapped
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // First byte of the mapping, page aligned
+    const uint8_t* data() const { return bytes; }
+
+    // Length of the file in bytes
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes;  // Start of the mapping
+    size_t length;  // Mapped length
+};
+
+// Keys read from a keystore; the keys point into the mapping and keep it alive
+struct KeystoreKeys {
+    int n;  // Ring degree
+    int q;  // Modulus
+    RingKey secret;  // Secret key, empty when the keystore holds the public key only
+    std::pair<RingKey, RingKey> public_keys;  // Public key pair (a, b)
+};
+
+// Writes the engine's keys, with their NTT-domain forms, to path; the file is created with mode 0600 and
+// replaced atomically, and the directory is synced so the rename survives a crash. Throws std::runtime_error on
+// I/O errors and std::logic_error when include_secret is set on an engine without a secret key.
+void write_keystore(const std::string& path, const RingLWEEngine& engine, bool include_secret = true);
+
+// Maps a keystore written by write_keystore. Throws std::runtime_error when the file cannot be mapped and
+// std::invalid_argument when it is malformed, including when a stored NTT-domain form is not the transform of its
+// coefficients.
+KeystoreKeys load_keystore(const std::string& path);
+
+}  // namespace lattice_crypto
+
+#endif  // KEYSTORE_H
@@ -1,47 +1,157 @@
 #ifndef LATTICE_CRYPTO_H
 #define LATTICE_CRYPTO_H
 
-#include <Eigen/Dense>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
+#include "eigen_interop.h"
+#include "ntt_plan.h"
+#include "polynomial.h"
+#include "randomness_pool.h"
+#include "ring_key.h"
+#include "ring_lwe.h"
 
 namespace lattice_crypto {
 
 // KeyGenerator handles the generation of keys and related cryptographic operations
 class KeyGenerator {
 public:
-    // Generates a random matrix of given dimensions using OpenSSL's secure random number generator
+    // Constructor taking the NTT plan to multiply with; a matching plan is built on first use when none is given
+    explicit KeyGenerator(std::shared_ptr<const NttPlan> plan = nullptr);
+
+    // Generates a polynomial with coefficients in {0, 1}; all sampling goes through this thread's Sampler
+    RingElement generate_random_polynomial(int n);
+
+    // Generates a polynomial with coefficients drawn uniformly from [0, q)
+    RingElement generate_uniform_polynomial(int n, int q);
+
+    // Generates a polynomial of centered binomial errors (eta = 5), reduced into [0, q)
+    RingElement generate_error_polynomial(int n, int q);
+
+    // Multiplies a by b in Z_q[x]/(x^n + 1) using the Number Theoretic Transform (NTT)
+    RingElement polynomial_multiply(const RingElement& a, const RingElement& b, int q);
+
+    // Generates the public key pair (a, a * secret_key + e) for the given secret key
+    std::pair<RingElement, RingElement> generate_keys(const RingElement& secret_key, int q);
+
+    // Compatibility shims for Eigen callers
+
+    // Generates a random {0, 1} matrix of given dimensions
     Eigen::MatrixXi generate_random_matrix(int rows, int cols);
 
-    // Performs polynomial multiplication using Number Theoretic Transform (NTT)
-    Eigen::MatrixXi polynomial_multiply(const Eigen::MatrixXi& a, const Eigen::MatrixXi& b, int q);
+    // Generates a matrix with coefficients drawn uniformly from [0, q)
+    Eigen::MatrixXi generate_uniform_matrix(int rows, int cols, int q);
 
-    // Generates both secret and public keys
-    std::pair<Eigen::MatrixXi, Eigen::MatrixXi> generate_keys(int rows, int cols, int q);
+    // Multiplies row 0 of a by column 0 of b in Z_q[x]/(x^n + 1)
+    Eigen::MatrixXi polynomial_multiply(const Eigen::MatrixXi& a, const Eigen::MatrixXi& b, int q);
 
     // Generates binomially distributed error values
-    Eigen::MatrixXi generate_binomial_error(int rows, int cols);  // This is required as used in the cpp file
+    Eigen::MatrixXi generate_binomial_error(int rows, int cols);
+
+private:
+    // Returns the cached plan, rebuilding it when (n, q) differs from the one it was made for
+    const NttPlan& plan_for(int n, int q);
+
+    std::shared_ptr<const NttPlan> plan;  // NTT plan shared with the owning RingLWECrypto
 };
 
-// RingLWECrypto handles encryption and decryption using Ring Learning with Errors (Ring-LWE) cryptography
+// RingLWECrypto handles encryption and decryption using Ring Learning with Errors (Ring-LWE) cryptography.
+// It is a thin runtime wrapper that dispatches to the RingLWE<P> engine matching (poly_degree, modulus).
+// The keys are read-only after construction, so encrypt and decrypt may be called from any number of threads.
 class RingLWECrypto {
 public:
-    // Constructor with default parameters for polynomial degree and modulus
-    RingLWECrypto(int poly_degree = 512, int modulus = 4096);
+    // Constructor with default parameters for polynomial degree and modulus; the pair must name one of
+    // the parameter sets in param_sets.h, otherwise std::invalid_argument is thrown
+    RingLWECrypto(int poly_degree = 512, int modulus = 12289);
+
+    // Same, with the transforms on the given kernels instead of the fastest the CPU supports; for tests and benchmarks
+    RingLWECrypto(int poly_degree, int modulus, const NttKernels& kernels);
+
+    // Rebuilds an instance from public_key_bytes() and, optionally, secret_key_bytes(); without the secret key
+    // the instance can only encrypt. Throws std::invalid_argument on malformed or mismatched keys.
+    static RingLWECrypto from_key_bytes(std::string_view public_key, std::string_view secret_key = {});
+
+    // Maps a keystore written by save_keystore; the keys are used in place, so nothing is generated or transformed
+    static RingLWECrypto from_keystore(const std::string& path);
 
     // Encrypts the given plaintext and returns a pair of ciphertexts (c1, c2)
-    std::pair<Eigen::MatrixXi, Eigen::MatrixXi> encrypt(const std::string& plaintext);
+    Ciphertext encrypt(std::string_view plaintext);
+
+    // Decrypts the given ciphertext pair and returns the original plaintext as hex
+    std::string decrypt(const Ciphertext& ciphertext);
+
+    // Decrypts the given ciphertext pair and returns the original plaintext bytes
+    std::string decrypt_bytes(const Ciphertext& ciphertext);
+
+    // Encrypts into out, reusing its storage; once out has the right size, this allocates nothing.
+    // With a randomness pool enabled, encrypt and encrypt_into take a precomputed entry when one is ready.
+    void encrypt_into(std::string_view plaintext, Ciphertext& out);
 
-    // Decrypts the given ciphertext pair and returns the original plaintext
+    // Starts precomputing the message-independent part of encryptions, so encrypt only encodes the message and adds.
+    // Replaces any pool already running; safe while other threads encrypt. Batches and streams do not draw from the
+    // pool, so bulk work cannot drain it. In a forked child the pool stops serving; enable one there after the fork.
+    void enable_randomness_pool(const RandomnessPoolOptions& options = {});
+
+    // Stops the pool and wipes its entries once no encryption is using it; encryption goes back to doing all the work per call
+    void disable_randomness_pool();
+
+    // The running pool, or nullptr
+    std::shared_ptr<RandomnessPool> randomness_pool() const;
+
+    // Decrypts to raw bytes into out, reusing its storage; allocates nothing once out has max_plaintext_size() capacity
+    void decrypt_into(const Ciphertext& ciphertext, std::string& out);
+
+    // Decrypts a ciphertext pair held as Eigen row vectors (compatibility shim)
     std::string decrypt(const std::pair<Eigen::MatrixXi, Eigen::MatrixXi>& ciphertext);
 
+    // Encrypts every plaintext on the shared thread pool; results are in input order
+    std::vector<Ciphertext> encrypt_batch(const std::vector<std::string>& plaintexts);
+
+    // Same, over views of plaintexts owned elsewhere (e.g. Python buffers)
+    std::vector<Ciphertext> encrypt_batch(const std::vector<std::string_view>& plaintexts);
+
+    // Decrypts every ciphertext on the shared thread pool to hex; results are in input order
+    std::vector<std::string> decrypt_batch(const std::vector<Ciphertext>& ciphertexts);
+
+    // Decrypts every ciphertext on the shared thread pool to raw bytes; results are in input order
+    std::vector<std::string> decrypt_batch_bytes(const std::vector<Ciphertext>& ciphertexts);
+
+    // Number of plaintext bytes that fit in one ciphertext
+    size_t max_plaintext_size() const;
+
+    // Public key pair (a, b) in the bit-packed format of serialization.h
+    std::string public_key_bytes() const;
+
+    // Secret key s in the bit-packed format; throws std::logic_error when the instance has none
+    std::string secret_key_bytes() const;
+
+    // Writes the keys and their NTT-domain forms to a keystore file for from_keystore; with include_secret false
+    // the keystore only allows encryption
+    void save_keystore(const std::string& path, bool include_secret = true) const;
+
+    // Ciphertext (c1, c2) in the bit-packed format
+    std::string to_bytes(const Ciphertext& ciphertext) const;
+
+    // Parses a ciphertext written by to_bytes; throws std::invalid_argument when it is malformed or made
+    // for other parameters
+    Ciphertext ciphertext_from_bytes(std::string_view data) const;
+
+    // Transform plan of the selected parameter set
+    const NttPlan& plan() const;
+
+    // Engine for the selected parameter set
+    RingLWEEngine& engine() const { return *lwe_engine; }
+
 private:
+    // Wraps an engine built elsewhere
+    explicit RingLWECrypto(std::unique_ptr<RingLWEEngine> engine);
+
     int poly_degree;  // Degree of the polynomial used in cryptographic operations
     int q;  // Modulus value
-    std::unique_ptr<KeyGenerator> key_gen;  // Key generation utility
-    Eigen::MatrixXi secret_key;  // Secret key matrix
-    std::pair<Eigen::MatrixXi, Eigen::MatrixXi> public_key;  // Public key pair
+    std::unique_ptr<RingLWEEngine> lwe_engine;  // Compile-time parameter engine doing the actual work
+    std::shared_ptr<RandomnessPool> pool;  // Precomputed encryption randomness, when enabled; only accessed through std::atomic_load and std::atomic_store
 };
 
 }  // namespace lattice_crypto
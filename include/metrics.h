@@ -0,0 +1,198 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Metrics are compiled in unless the build sets -DLATTICE_CRYPTO_METRICS=0, which turns every
+// CRYPTO_METRIC_* statement into dead code; the snapshot functions then report zeros.
+#ifndef LATTICE_CRYPTO_METRICS
+#define LATTICE_CRYPTO_METRICS 1
+#endif
+
+#define LATTICE_CRYPTO_METRIC_JOIN2(a, b) a##b
+#define LATTICE_CRYPTO_METRIC_JOIN(a, b) LATTICE_CRYPTO_METRIC_JOIN2(a, b)
+
+#if LATTICE_CRYPTO_METRICS
+// Adds amount to a counter, e.g. CRYPTO_METRIC_COUNT(bytes_encrypted, plaintext.size());
+#define CRYPTO_METRIC_COUNT(counter, amount) \
+    ::lattice_crypto::count_metric(::lattice_crypto::Counter::counter, static_cast<uint64_t>(amount))
+
+// Records the time from here to the end of the enclosing scope in a latency histogram, e.g. CRYPTO_METRIC_TIMER(encrypt);
+#define CRYPTO_METRIC_TIMER(histogram)                                                   \
+    ::lattice_crypto::MetricTimer LATTICE_CRYPTO_METRIC_JOIN(metric_timer_, __LINE__)( \
+        ::lattice_crypto::Histogram::histogram)
+#else
+#define CRYPTO_METRIC_COUNT(counter, amount) \
+    do {                                     \
+    } while (false)
+#define CRYPTO_METRIC_TIMER(histogram) \
+    do {                               \
+    } while (false)
+#endif
+
+namespace lattice_crypto {
+
+// Monotonic counters
+enum class Counter : int {
+    bytes_encrypted,  // Plaintext bytes passed to encrypt
+    bytes_decrypted,  // Plaintext byte slots recovered by decrypt
+    sampled_coefficients,  // Coefficients drawn by the samplers
+    allocations,  // Ring element storage allocations
+    allocated_bytes,  // Bytes of ring element storage allocated
+    pool_hits,  // Encryptions served from a RandomnessPool
+    pool_misses,  // Encryptions that found their RandomnessPool empty
+    pool_precomputed,  // Entries a RandomnessPool has precomputed
+    count  // Number of counters, not a counter
+};
+
+// Latency histograms, in nanoseconds
+enum class Histogram : int {
+    keygen,  // Generating a key pair
+    encrypt,  // One encryption
+    decrypt,  // One decryption
+    ntt,  // One forward or inverse transform in the engine
+    sampling,  // One sampler fill
+    count  // Number of histograms, not a histogram
+};
+
+constexpr size_t kCounterCount = static_cast<size_t>(Counter::count);
+constexpr size_t kHistogramCount = static_cast<size_t>(Histogram::count);
+
+// Histograms are log-linear like HdrHistogram: values below 16 ns get a bucket each, and every power of two
+// above is split into 16 buckets, so a bucket is never wider than 1/16 of its lower bound
+constexpr int kHistogramSubBucketBits = 4;
+constexpr size_t kHistogramSubBuckets = size_t(1) << kHistogramSubBucketBits;
+
+// Largest power of two kept apart; longer events (over about 18 minutes) share the last bucket
+constexpr int kHistogramMaxExponent = 39;
+
+constexpr size_t kHistogramBuckets = (kHistogramMaxExponent - kHistogramSubBucketBits + 2) * kHistogramSubBuckets;
+
+// Bucket a value of ns nanoseconds is counted in
+inline size_t histogram_bucket(uint64_t ns) {
+    if (ns < kHistogramSubBuckets) return static_cast<size_t>(ns);
+#if defined(__GNUC__) || defined(__clang__)
+    int exponent = 63 - __builtin_clzll(ns);
+#else
+    int exponent = 0;
+    for (uint64_t v = ns; v > 1; v >>= 1) ++exponent;
+#endif
+    if (exponent > kHistogramMaxExponent) return kHistogramBuckets - 1;
+    size_t sub = static_cast<size_t>(ns >> (exponent - kHistogramSubBucketBits)) & (kHistogramSubBuckets - 1);
+    return static_cast<size_t>(exponent - kHistogramSubBucketBits + 1) * kHistogramSubBuckets + sub;
+}
+
+// Smallest value counted in a bucket
+uint64_t histogram_bucket_lower(size_t bucket);
+
+// One past the largest value counted in a bucket
+uint64_t histogram_bucket_upper(size_t bucket);
+
+namespace detail {
+
+// Per-thread histogram; only its owning thread writes it
+struct HistogramShard {
+    std::atomic<uint64_t> buckets[kHistogramBuckets];  // Events per bucket
+    std::atomic<uint64_t> sum;  // Total nanoseconds
+    std::atomic<uint64_t> max;  // Longest event
+};
+
+// Per-thread metrics. The owning thread updates them with plain relaxed loads and stores, never a read-modify-write,
+// and snapshots read them with relaxed loads, so recording an event costs a few uncontended memory operations.
+struct MetricShard {
+    std::atomic<uint64_t> counters[kCounterCount];  // Counter values
+    HistogramShard histograms[kHistogramCount];  // Latency histograms
+};
+
+// This thread's shard, registered on first use and folded into the process totals when the thread exits
+MetricShard& local_shard();
+
+// Adds amount to a value only the calling thread writes
+inline void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+// Adds amount to a counter of the calling thread
+inline void count_metric(Counter counter, uint64_t amount) {
+    detail::bump(detail::local_shard().counters[static_cast<size_t>(counter)], amount);
+}
+
+// Records one event of ns nanoseconds
+inline void record_latency(Histogram histogram, uint64_t ns) {
+    detail::HistogramShard& shard = detail::local_shard().histograms[static_cast<size_t>(histogram)];
+    detail::bump(shard.buckets[histogram_bucket(ns)], 1);
+    detail::bump(shard.sum, ns);
+    if (ns > shard.max.load(std::memory_order_relaxed)) shard.max.store(ns, std::memory_order_relaxed);
+}
+
+// MetricTimer records the time between its construction and destruction; use it through CRYPTO_METRIC_TIMER
+class MetricTimer {
+public:
+    explicit MetricTimer(Histogram histogram) : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+
+    ~MetricTimer() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        record_latency(histogram, static_cast<uint64_t>(elapsed.count()));
+    }
+
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+
+private:
+    Histogram histogram;  // Where the event is recorded
+    std::chrono::steady_clock::time_point start;  // Construction time
+};
+
+// Totals of one histogram across all threads
+struct HistogramSnapshot {
+    uint64_t count = 0;  // Events
+    uint64_t sum_ns = 0;  // Total nanoseconds
+    uint64_t max_ns = 0;  // Longest event since the process started; not cleared by reset_metrics
+    std::vector<uint64_t> buckets;  // Events per bucket, kHistogramBuckets entries
+
+    // Mean event length in nanoseconds; 0 without events
+    double mean_ns() const;
+
+    // Upper bound of the bucket holding the given quantile in [0, 1]; 0 without events
+    uint64_t quantile_ns(double quantile) const;
+};
+
+// Totals of every metric across all threads, including threads that have exited
+struct MetricsSnapshot {
+    std::array<uint64_t, kCounterCount> counters{};  // Counter values
+    std::array<HistogramSnapshot, kHistogramCount> histograms;  // Latency histograms
+
+    uint64_t counter(Counter c) const { return counters[static_cast<size_t>(c)]; }
+    const HistogramSnapshot& histogram(Histogram h) const { return histograms[static_cast<size_t>(h)]; }
+};
+
+// True when the library was built with LATTICE_CRYPTO_METRICS
+bool metrics_enabled();
+
+// Name of a counter, e.g. "bytes_encrypted"
+const char* counter_name(Counter counter);
+
+// Name of a histogram, e.g. "encrypt"
+const char* histogram_name(Histogram histogram);
+
+// Sums every thread's metrics; safe to call while other threads record
+MetricsSnapshot metrics_snapshot();
+
+// Starts every counter and histogram from zero again; recording threads are never written to, the current
+// totals just become the baseline later snapshots are taken against
+void reset_metrics();
+
+// Metrics in the Prometheus text exposition format, with latency histograms in seconds
+std::string metrics_prometheus();
+
+}  // namespace lattice_crypto
+
+#endif  // METRICS_H
@@ -0,0 +1,90 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace lattice_crypto {
+
+// MpmcQueue is a bounded lock-free multi-producer multi-consumer queue (Vyukov's design).
+// Every cell carries a sequence number telling producers and consumers whose turn it is, so
+// a push or pop is one compare-and-swap on the shared position plus one release store.
+// Neither operation blocks: try_push fails when the queue is full, try_pop when it is empty.
+template <class T>
+class MpmcQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit MpmcQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    // Number of cells
+    size_t capacity() const { return mask + 1; }
+
+    // Copies value into the queue; false when the queue is full
+    bool try_push(const T& value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // The consumer has not freed this cell yet: full
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);  // Another producer took it
+            }
+        }
+    }
+
+    // Moves the oldest element into value; false when the queue is empty
+    bool try_pop(T& value) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // No producer has filled this cell yet: empty
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);  // Another consumer took it
+            }
+        }
+    }
+
+private:
+    // One slot; aligned so neighbouring cells never share a cache line
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;  // Ring of cells
+    size_t mask = 0;  // capacity - 1
+    alignas(64) std::atomic<size_t> enqueue_pos{0};  // Next cell to fill
+    alignas(64) std::atomic<size_t> dequeue_pos{0};  // Next cell to drain
+};
+
+}  // namespace lattice_crypto
+
+#endif  // MPMC_QUEUE_H
@@ -0,0 +1,41 @@
+#ifndef NTT_KERNELS_H
+#define NTT_KERNELS_H
+
+#include <cstdint>
+
+namespace lattice_crypto {
+
+// Instruction sets the arithmetic kernels are built for
+enum class KernelIsa { scalar, avx2, avx512 };
+
+// Modulus with its Barrett constant; q must be below 2^16 so coefficient products fit in 32 bits
+struct Modulus {
+    uint32_t q;  // Modulus value
+    uint32_t barrett;  // floor(2^32 / q)
+};
+
+// Builds the Barrett constants for q; throws std::invalid_argument when q is outside [2, 2^16)
+Modulus make_modulus(int q);
+
+// NttKernels is one implementation of the hot loops; every implementation gives bit-identical results
+struct NttKernels {
+    KernelIsa isa;  // Instruction set the kernels use
+    const char* name;  // Human readable name for logs and tests
+
+    // Runs every butterfly stage of a bit-reversed, in-place cyclic transform of size n;
+    // the stage of half-length h reads its twiddles from twiddles[h - 1 .. 2h - 2]
+    void (*butterflies)(int32_t* a, int n, const int32_t* twiddles, const Modulus& mod);
+
+    // out[i] = a[i] * b[i] mod q for n coefficients in [0, q); out may alias a or b
+    void (*pointwise)(const int32_t* a, const int32_t* b, int32_t* out, int n, const Modulus& mod);
+};
+
+// Returns the fastest kernels this CPU supports, detected once from CPUID
+const NttKernels& active_kernels();
+
+// Returns the kernels for a specific instruction set, or nullptr when they are not built in or the CPU lacks them
+const NttKernels* kernels_for(KernelIsa isa);
+
+}  // namespace lattice_crypto
+
+#endif  // NTT_KERNELS_H
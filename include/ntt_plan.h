@@ -0,0 +1,81 @@
+#ifndef NTT_PLAN_H
+#define NTT_PLAN_H
+
+#include <cstdint>
+#include <vector>
+#include "ntt_kernels.h"
+
+namespace lattice_crypto {
+
+// NttTableView points at precomputed transform tables owned elsewhere, such as the constexpr tables of a parameter set
+struct NttTableView {
+    int n;  // Polynomial degree
+    int q;  // Modulus
+    int psi;  // Primitive 2n-th root of unity
+    int inv_n;  // n^-1 mod q
+    const int32_t* bit_reversal;  // n entries
+    const int32_t* forward_twiddles;  // n - 1 entries, stage-major
+    const int32_t* inverse_twiddles;  // n - 1 entries, stage-major
+    const int32_t* twist;  // n entries, psi^i
+    const int32_t* untwist;  // n entries, n^-1 * psi^-i
+};
+
+// NttPlan holds everything a negacyclic Number Theoretic Transform over Z_q[x]/(x^n + 1) needs,
+// computed once per (n, q) so that the transforms themselves only do butterfly arithmetic
+class NttPlan {
+public:
+    // Builds the plan; throws std::invalid_argument unless n is a power of two and q < 2^16 is a prime with q = 1 (mod 2n).
+    // The transforms run on the given kernels, by default the fastest ones the CPU supports.
+    NttPlan(int n, int q, const NttKernels& kernels = active_kernels());
+
+    // Wraps tables computed elsewhere without copying them; they must outlive the plan
+    explicit NttPlan(const NttTableView& tables, const NttKernels& kernels = active_kernels());
+
+    NttPlan(const NttPlan&) = delete;
+    NttPlan& operator=(const NttPlan&) = delete;
+
+    // Polynomial degree the plan transforms
+    int size() const { return n; }
+
+    // Modulus of the coefficient ring
+    int modulus() const { return q; }
+
+    // Primitive 2n-th root of unity used for the negacyclic twist
+    int root() const { return psi; }
+
+    // Modular inverse of n, applied at the end of every inverse transform
+    int inverse_n() const { return inv_n; }
+
+    // Kernels the transforms run on
+    const NttKernels& kernel_set() const { return *kernels; }
+
+    // In-place forward transform of n coefficients in [0, q)
+    void forward(int32_t* a) const;
+
+    // In-place inverse transform of n coefficients in [0, q), including the scaling by n^-1
+    void inverse(int32_t* a) const;
+
+    // Coefficient-wise product of two transformed polynomials; out may alias a or b
+    void pointwise(const int32_t* a, const int32_t* b, int32_t* out) const;
+
+private:
+    // Bit-reversal permutation shared by forward and inverse transforms
+    void permute(int32_t* a) const;
+
+    int n;  // Polynomial degree
+    int q;  // Modulus
+    int psi;  // Primitive 2n-th root of unity
+    int inv_n;  // n^-1 mod q
+    Modulus mod;  // q with its Barrett constant
+    const NttKernels* kernels;  // Arithmetic kernels for the butterflies and pointwise products
+    const int32_t* bit_reversal;  // Bit-reversal permutation of [0, n)
+    const int32_t* forward_twiddles;  // Stage twiddles; the stage of half-length h starts at index h - 1
+    const int32_t* inverse_twiddles;  // Same layout as forward_twiddles, built from the inverse root
+    const int32_t* twist;  // psi^i, turns the cyclic transform into a negacyclic one
+    const int32_t* untwist;  // n^-1 * psi^-i, undoes the twist and the scaling in one pass
+    std::vector<int32_t> storage;  // Backing store for the tables when the plan computes them itself
+};
+
+}  // namespace lattice_crypto
+
+#endif  // NTT_PLAN_H
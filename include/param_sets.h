@@ -0,0 +1,144 @@
+#ifndef PARAM_SETS_H
+#define PARAM_SETS_H
+
+#include <array>
+#include <cstdint>
+#include "ntt_plan.h"
+
+namespace lattice_crypto {
+
+// Named Ring-LWE parameter sets. Each one fixes the ring degree N and an NTT-friendly prime q;
+// everything derived from them is computed at compile time by NttTables below.
+
+// N = 256 over the prime 7681 = 15 * 512 + 1
+struct Params256 {
+    static constexpr int N = 256;
+    static constexpr int q = 7681;
+    static constexpr const char* name = "n256-q7681";
+};
+
+// N = 512 over the prime 12289 = 12 * 1024 + 1
+struct Params512 {
+    static constexpr int N = 512;
+    static constexpr int q = 12289;
+    static constexpr const char* name = "n512-q12289";
+};
+
+// N = 1024 over the prime 12289 = 6 * 2048 + 1
+struct Params1024 {
+    static constexpr int N = 1024;
+    static constexpr int q = 12289;
+    static constexpr const char* name = "n1024-q12289";
+};
+
+namespace detail {
+
+constexpr int64_t constexpr_pow_mod(int64_t base, int64_t exp, int64_t mod) {
+    int64_t result = 1;
+    base %= mod;
+    while (exp > 0) {
+        if (exp & 1) result = (result * base) % mod;
+        base = (base * base) % mod;
+        exp >>= 1;
+    }
+    return result;
+}
+
+constexpr bool constexpr_is_prime(int value) {
+    if (value < 2) return false;
+    for (int d = 2; 1LL * d * d <= value; ++d) {
+        if (value % d == 0) return false;
+    }
+    return true;
+}
+
+// Smallest g with g^n = -1 (mod q), i.e. a primitive 2n-th root of unity; 0 when none exists.
+// Matches the root NttPlan picks at runtime, so both produce identical transforms.
+constexpr int constexpr_find_psi(int n, int q) {
+    for (int g = 2; g < q; ++g) {
+        if (constexpr_pow_mod(g, n, q) == q - 1) return g;
+    }
+    return 0;
+}
+
+template <int N>
+constexpr std::array<int32_t, N> make_bit_reversal() {
+    std::array<int32_t, N> table{};
+    int log_n = 0;
+    while ((1 << log_n) < N) ++log_n;
+    for (int i = 0; i < N; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < log_n; ++b) {
+            if (i & (1 << b)) reversed |= 1 << (log_n - 1 - b);
+        }
+        table[i] = reversed;
+    }
+    return table;
+}
+
+// Stage-major twiddles: the stage of half-length h holds omega^(N / 2h * j) for j < h at index h - 1 + j
+template <int N>
+constexpr std::array<int32_t, N - 1> make_twiddles(int64_t omega, int64_t q) {
+    std::array<int32_t, N - 1> table{};
+    for (int half = 1; half < N; half <<= 1) {
+        int64_t w_length = constexpr_pow_mod(omega, N / (2 * half), q);
+        int64_t w = 1;
+        for (int j = 0; j < half; ++j) {
+            table[half - 1 + j] = static_cast<int32_t>(w);
+            w = (w * w_length) % q;
+        }
+    }
+    return table;
+}
+
+// scale * root^i for i < N
+template <int N>
+constexpr std::array<int32_t, N> make_powers(int64_t root, int64_t scale, int64_t q) {
+    std::array<int32_t, N> table{};
+    int64_t value = scale;
+    for (int i = 0; i < N; ++i) {
+        table[i] = static_cast<int32_t>(value);
+        value = (value * root) % q;
+    }
+    return table;
+}
+
+}  // namespace detail
+
+// NttTables<P> holds the transform tables of a parameter set, generated entirely at compile time.
+// A parameter set that is not NTT-friendly fails here instead of at runtime.
+template <class P>
+struct NttTables {
+    static constexpr int N = P::N;
+    static constexpr int q = P::q;
+
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Ring degree must be a power of two");
+    static_assert(q > 2 && q < (1 << 16), "Modulus must fit in 16 bits so coefficient products fit in 32 bits");
+    static_assert(detail::constexpr_is_prime(q), "Modulus must be prime");
+    static_assert((q - 1) % (2 * N) == 0, "Modulus must satisfy q = 1 (mod 2N) for a negacyclic NTT");
+
+    static constexpr int psi = detail::constexpr_find_psi(N, q);
+    static_assert(psi != 0, "No primitive 2N-th root of unity modulo q");
+
+    static constexpr int inv_psi = static_cast<int>(detail::constexpr_pow_mod(psi, q - 2, q));
+    static constexpr int omega = static_cast<int>(detail::constexpr_pow_mod(psi, 2, q));
+    static constexpr int inv_omega = static_cast<int>(detail::constexpr_pow_mod(inv_psi, 2, q));
+    static constexpr int inv_n = static_cast<int>(detail::constexpr_pow_mod(N, q - 2, q));
+    static_assert((1LL * N * inv_n) % q == 1, "n^-1 must invert n");
+
+    static constexpr std::array<int32_t, N> bit_reversal = detail::make_bit_reversal<N>();
+    static constexpr std::array<int32_t, N - 1> forward_twiddles = detail::make_twiddles<N>(omega, q);
+    static constexpr std::array<int32_t, N - 1> inverse_twiddles = detail::make_twiddles<N>(inv_omega, q);
+    static constexpr std::array<int32_t, N> twist = detail::make_powers<N>(psi, 1, q);
+    static constexpr std::array<int32_t, N> untwist = detail::make_powers<N>(inv_psi, inv_n, q);
+
+    // Exposes the tables to NttPlan without copying them
+    static NttTableView view() {
+        return {N, q, psi, inv_n, bit_reversal.data(), forward_twiddles.data(), inverse_twiddles.data(),
+                twist.data(), untwist.data()};
+    }
+};
+
+}  // namespace lattice_crypto
+
+#endif  // PARAM_SETS_H
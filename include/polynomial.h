@@ -0,0 +1,81 @@
+#ifndef POLYNOMIAL_H
+#define POLYNOMIAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include "metrics.h"
+
+namespace lattice_crypto {
+
+// Alignment of coefficient storage, wide enough for a full AVX-512 register or a cache line
+constexpr std::size_t kCoefficientAlignment = 64;
+
+// AlignedAllocator hands out storage aligned to Alignment bytes so ring elements can be loaded with aligned SIMD moves
+template <class T, std::size_t Alignment = kCoefficientAlignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        CRYPTO_METRIC_COUNT(allocations, 1);
+        CRYPTO_METRIC_COUNT(allocated_bytes, n * sizeof(T));
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) { return true; }
+    friend bool operator!=(const AlignedAllocator&, const AlignedAllocator&) { return false; }
+};
+
+// RingElement is one element of Z_q[x]/(x^n + 1): n contiguous, 64-byte aligned coefficients, normally kept in [0, q)
+class RingElement {
+public:
+    using Storage = std::vector<int32_t, AlignedAllocator<int32_t>>;
+
+    RingElement() = default;
+
+    // Creates a zero polynomial with n coefficients
+    explicit RingElement(std::size_t n) : coeffs(n, 0) {}
+
+    // Number of coefficients
+    std::size_t size() const { return coeffs.size(); }
+
+    // True for the zero-length element, e.g. a key that was never set
+    bool empty() const { return coeffs.empty(); }
+
+    // Raw access to the coefficient storage
+    int32_t* data() { return coeffs.data(); }
+    const int32_t* data() const { return coeffs.data(); }
+
+    int32_t& operator[](std::size_t i) { return coeffs[i]; }
+    const int32_t& operator[](std::size_t i) const { return coeffs[i]; }
+
+    Storage::iterator begin() { return coeffs.begin(); }
+    Storage::iterator end() { return coeffs.end(); }
+    Storage::const_iterator begin() const { return coeffs.begin(); }
+    Storage::const_iterator end() const { return coeffs.end(); }
+
+    bool operator==(const RingElement& other) const { return coeffs == other.coeffs; }
+    bool operator!=(const RingElement& other) const { return coeffs != other.coeffs; }
+
+private:
+    Storage coeffs;  // Coefficient storage, lowest degree first
+};
+
+}  // namespace lattice_crypto
+
+#endif  // POLYNOMIAL_H
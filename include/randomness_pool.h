@@ -0,0 +1,85 @@
+#ifndef RANDOMNESS_POOL_H
+#define RANDOMNESS_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <sys/types.h>
+#include <thread>
+#include "mpmc_queue.h"
+#include "polynomial.h"
+#include "ring_lwe.h"
+
+namespace lattice_crypto {
+
+// How a RandomnessPool is sized and refilled
+struct RandomnessPoolOptions {
+    size_t depth = 64;  // Precomputed encryptions kept ready
+    size_t refill_below = 32;  // The refill thread tops the pool up once fewer than this many are ready
+    bool background = true;  // Refill on a background thread; when false only refill() adds entries
+};
+
+// RandomnessPool splits encryption into an offline and an online phase. Offline, it computes the
+// message-independent part of encryptions ahead of time: c1 = a * r + e1 and b * r + e2 for fresh r, e1 and e2,
+// which is all the sampling and every transform. Online, encrypt_into copies one entry out and adds the encoded
+// message, so a hit costs a copy and one pass over the coefficients.
+//
+// Entries sit in a preallocated slab; ready and free slots move through two lock-free queues, so encrypt_into
+// never blocks and never allocates. Each entry is handed out once and wiped as it is taken. A pool only serves
+// the process that created it: after fork the child falls back to the engine rather than reuse the parent's entries,
+// and a child that destroys or replaces the inherited pool only wipes the entries, since the refill thread is the parent's.
+class RandomnessPool {
+public:
+    // Starts the pool over an engine that must outlive it; with options.background the first fill starts at once
+    explicit RandomnessPool(RingLWEEngine& engine, const RandomnessPoolOptions& options = {});
+
+    // Stops the refill thread and wipes every entry; in a forked child it only wipes the entries
+    ~RandomnessPool();
+
+    RandomnessPool(const RandomnessPool&) = delete;
+    RandomnessPool& operator=(const RandomnessPool&) = delete;
+
+    // Encrypts into out from a precomputed entry, or through the engine when the pool is empty.
+    // Safe to call from any number of threads.
+    void encrypt_into(std::string_view plaintext, Ciphertext& out);
+
+    // Fills the pool up to its depth on the calling thread; returns the number of entries added
+    size_t refill();
+
+    // Entries ready to be taken
+    size_t ready() const { return available.load(std::memory_order_relaxed); }
+
+    // Capacity of the pool
+    size_t depth() const { return options.depth; }
+
+private:
+    // Refill thread and what it sleeps on. Held on the heap so a forked child can drop its copy untouched: the thread
+    // does not exist there, and notifying, joining or destroying the parent's state would block forever.
+    struct Refiller {
+        std::mutex wake_mutex;  // Guards the refill thread's sleep
+        std::condition_variable wake;  // Wakes the refill thread
+        std::thread thread;  // Background refill thread, when enabled
+    };
+
+    // Refill thread: sleep until the pool runs low, then fill it
+    void run();
+
+    RingLWEEngine& engine;  // Engine computing the entries
+    RandomnessPoolOptions options;  // Depth and refill policy
+    size_t n;  // Coefficients per polynomial
+    RingElement::Storage slab;  // depth entries of (c1, mask), 2n coefficients each
+    MpmcQueue<uint32_t> ready_slots;  // Entries ready to be taken
+    MpmcQueue<uint32_t> free_slots;  // Entries waiting to be computed
+    std::atomic<size_t> available{0};  // Entries in ready_slots
+    pid_t owner;  // Process whose entries these are
+    std::atomic<bool> stopping{false};  // Set once by the destructor
+    std::unique_ptr<Refiller> refiller;  // Never null in the creating process
+};
+
+}  // namespace lattice_crypto
+
+#endif  // RANDOMNESS_POOL_H
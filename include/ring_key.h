@@ -0,0 +1,64 @@
+#ifndef RING_KEY_H
+#define RING_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "ntt_plan.h"
+#include "polynomial.h"
+
+namespace lattice_crypto {
+
+// RingKey holds a key in coefficient form next to its NTT-domain form. An owned key computes the NTT-domain
+// form the first time it is needed; a mapped key points at both forms in storage owned elsewhere, such as a
+// memory-mapped keystore, and computes nothing.
+// A key is read-only once constructed and may be shared by any number of threads; the one-time transform is
+// guarded by std::call_once. The NTT-domain form belongs to one transform, identified by its modulus and root;
+// asking for it under a plan with another modulus or root throws instead of returning the wrong form.
+class RingKey {
+public:
+    RingKey();
+
+    // Wraps the coefficient form of a key
+    explicit RingKey(RingElement coefficients);
+
+    // Points at n coefficients and their NTT-domain form under the transform mod modulus with root psi, without copying
+    // them; owner keeps the storage alive
+    RingKey(std::shared_ptr<const void> owner, const int32_t* coefficients, const int32_t* ntt, size_t n, int modulus, int psi);
+
+    // Number of coefficients; zero for a key that was never set
+    size_t size() const { return view ? view_size : coeffs.size(); }
+
+    // True for a key that was never set
+    bool empty() const { return size() == 0; }
+
+    // Returns the key in coefficient form
+    const int32_t* data() const { return view ? view_coeffs : coeffs.data(); }
+
+    // Returns the key in the NTT domain of the given plan, transforming it on first use. Throws
+    // std::invalid_argument when the plan's size, modulus or root differs from the form the key holds.
+    const int32_t* ntt_data(const NttPlan& plan) const;
+
+private:
+    // NTT-domain form and the flag publishing it; held by pointer so RingKey stays movable
+    struct NttCache {
+        std::once_flag once;
+        RingElement ntt;
+        int modulus = 0;  // Modulus of the plan that made ntt
+        int psi = 0;  // Root of the plan that made ntt
+    };
+
+    RingElement coeffs;  // Coefficient form of an owned key
+    std::unique_ptr<NttCache> cache;  // NTT-domain form of an owned key, empty until first use
+    std::shared_ptr<const void> view;  // Owner of the storage of a mapped key, null for an owned key
+    const int32_t* view_coeffs = nullptr;  // Coefficient form of a mapped key
+    const int32_t* view_ntt = nullptr;  // NTT-domain form of a mapped key
+    size_t view_size = 0;  // Number of coefficients of a mapped key
+    int view_modulus = 0;  // Modulus of the transform behind view_ntt
+    int view_psi = 0;  // Root of the transform behind view_ntt
+};
+
+}  // namespace lattice_crypto
+
+#endif  // RING_KEY_H
@@ -0,0 +1,137 @@
+#ifndef RING_LWE_H
+#define RING_LWE_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "param_sets.h"
+#include "polynomial.h"
+#include "ring_key.h"
+
+namespace lattice_crypto {
+
+class KeyGenerator;
+
+// Ciphertext pair (c1, c2) produced by encrypt
+using Ciphertext = std::pair<RingElement, RingElement>;
+
+// RingLWEEngine is the parameter-independent interface RingLWECrypto dispatches through.
+// encrypt and decrypt only read the keys and sample through per-thread state, so they are safe to call concurrently.
+class RingLWEEngine {
+public:
+    virtual ~RingLWEEngine() = default;
+
+    // Ring degree N
+    virtual int degree() const = 0;
+
+    // Coefficient modulus q
+    virtual int modulus() const = 0;
+
+    // Name of the parameter set
+    virtual const char* name() const = 0;
+
+    // Number of plaintext bytes that fit in one ciphertext
+    virtual size_t max_plaintext_size() const = 0;
+
+    // Transform plan over the compile-time tables of the parameter set
+    virtual const NttPlan& plan() const = 0;
+
+    // Encrypts the given plaintext and returns a pair of ciphertexts (c1, c2)
+    virtual Ciphertext encrypt(std::string_view plaintext) = 0;
+
+    // Encrypts into out, reusing its storage; scratch comes from the thread's Workspace, so once out has the right
+    // size this allocates nothing
+    virtual void encrypt_into(std::string_view plaintext, Ciphertext& out) = 0;
+
+    // Writes the message-independent part of an encryption under a fresh ephemeral secret r: c1 = a * r + e1 and
+    // mask = b * r + e2, N coefficients each. Adding a message to mask with add_message completes c2.
+    virtual void encrypt_randomness(int32_t* c1, int32_t* mask) = 0;
+
+    // Adds the encoded plaintext to mask in place; throws std::invalid_argument when it does not fit
+    virtual void add_message(std::string_view plaintext, int32_t* mask) const = 0;
+
+    // Decrypts the given ciphertext pair and returns the plaintext as hex
+    virtual std::string decrypt(const Ciphertext& ciphertext) = 0;
+
+    // Decrypts the given ciphertext pair and returns the plaintext bytes, up to the first 0x00 or 0xff padding byte
+    virtual std::string decrypt_bytes(const Ciphertext& ciphertext) = 0;
+
+    // Decrypts like decrypt_bytes into out, reusing its storage; allocates nothing once out has max_plaintext_size() capacity
+    virtual void decrypt_into(const Ciphertext& ciphertext, std::string& out) = 0;
+
+    // Decrypts every byte slot of the ciphertext, padding included, into max_plaintext_size() bytes at out
+    virtual void decrypt_raw(const Ciphertext& ciphertext, uint8_t* out) = 0;
+
+    // Secret key; empty for an engine built from a public key only
+    virtual const RingKey& secret() const = 0;
+
+    // Public key pair (a, b)
+    virtual const std::pair<RingKey, RingKey>& public_keys() const = 0;
+};
+
+// RingLWE<P> is the Ring-LWE engine for one compile-time parameter set. N and q are constants,
+// so the scalar loops are fully specialized and every reduction compiles to multiply-and-shift.
+// It is explicitly instantiated for Params256, Params512 and Params1024.
+template <class P>
+class RingLWE final : public RingLWEEngine {
+public:
+    using Params = P;
+    using Tables = NttTables<P>;
+    static constexpr int N = P::N;
+    static constexpr int q = P::q;
+
+    // Generates a fresh key pair; the transforms run on kernels, and the scalar set selects the specialized loops
+    explicit RingLWE(const NttKernels& kernels = active_kernels());
+
+    // Uses an existing key pair; the secret key may be empty, which makes an encrypt-only engine
+    RingLWE(RingKey secret, std::pair<RingKey, RingKey> public_keys);
+    ~RingLWE() override;
+
+    int degree() const override { return N; }
+    int modulus() const override { return q; }
+    const char* name() const override { return P::name; }
+    size_t max_plaintext_size() const override;
+    const NttPlan& plan() const override { return *ntt_plan; }
+
+    Ciphertext encrypt(std::string_view plaintext) override;
+    void encrypt_into(std::string_view plaintext, Ciphertext& out) override;
+    void encrypt_randomness(int32_t* c1, int32_t* mask) override;
+    void add_message(std::string_view plaintext, int32_t* mask) const override;
+    std::string decrypt(const Ciphertext& ciphertext) override;
+    std::string decrypt_bytes(const Ciphertext& ciphertext) override;
+    void decrypt_into(const Ciphertext& ciphertext, std::string& out) override;
+    void decrypt_raw(const Ciphertext& ciphertext, uint8_t* out) override;
+    const RingKey& secret() const override { return secret_key; }
+    const std::pair<RingKey, RingKey>& public_keys() const override { return public_key; }
+
+private:
+    // Forward transform, on the SIMD kernels when the CPU has them and on the specialized scalar loops otherwise
+    void forward(int32_t* a) const;
+
+    // Inverse transform, dispatched like forward
+    void inverse(int32_t* a) const;
+
+    // Multiplies a key by an already transformed operand into product: one pointwise product and one inverse transform
+    void multiply_by_key(const RingKey& key, const int32_t* operand_ntt, int32_t* product) const;
+
+    std::shared_ptr<const NttPlan> ntt_plan;  // Plan over Tables, shared with key_gen
+    bool use_fixed_scalar;  // True when no SIMD kernels are available
+    std::unique_ptr<KeyGenerator> key_gen;  // Sampling utility
+    RingKey secret_key;  // Secret key polynomial
+    std::pair<RingKey, RingKey> public_key;  // Public key pair (a, b = a * s + e)
+};
+
+extern template class RingLWE<Params256>;
+extern template class RingLWE<Params512>;
+extern template class RingLWE<Params1024>;
+
+// Builds the engine for a runtime (n, q) on the given kernels; throws std::invalid_argument when no parameter set matches
+std::unique_ptr<RingLWEEngine> make_engine(int poly_degree, int modulus, const NttKernels& kernels = active_kernels());
+
+// Same, over an existing key pair; the secret key may be empty
+std::unique_ptr<RingLWEEngine> make_engine(int poly_degree, int modulus, RingKey secret, std::pair<RingKey, RingKey> public_keys);
+
+}  // namespace lattice_crypto
+
+#endif  // RING_LWE_H
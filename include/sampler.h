@@ -0,0 +1,76 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct evp_cipher_ctx_st;  // OpenSSL's EVP_CIPHER_CTX, kept out of this header
+
+namespace lattice_crypto {
+
+// Where a Sampler draws its random bytes from
+enum class SamplerSource {
+    system,   // OpenSSL RAND_bytes
+    aes_ctr,  // AES-256-CTR keystream under a caller-supplied seed, reproducible
+};
+
+// Sampler pulls randomness in large blocks and expands it into ring coefficients.
+// One RAND_bytes (or one EVP_EncryptUpdate) call covers kBlockBytes of output, so a
+// whole polynomial usually costs a single call into OpenSSL.
+// A Sampler is not thread-safe; use thread_local_instance() for one per thread.
+class Sampler {
+public:
+    // Bytes fetched from the source per refill
+    static constexpr size_t kBlockBytes = 4096;
+
+    // Sampler over OpenSSL's RAND_bytes
+    Sampler();
+
+    // Deterministic sampler over the AES-256-CTR keystream of a 32-byte seed
+    explicit Sampler(const std::array<uint8_t, 32>& seed);
+
+    ~Sampler();
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    // Source this sampler reads from
+    SamplerSource source() const { return src; }
+
+    // Copies count random bytes into out and wipes them from the internal block, so key material drawn here lives only
+    // in the caller's buffer
+    void fill_bytes(uint8_t* out, size_t count);
+
+    // Fills out with coefficients in {0, 1}, one random bit each. The integer fills wipe the bits they consume, so
+    // secrets and errors sampled here live only in out
+    void fill_binary(int32_t* out, size_t count);
+
+    // Fills out with coefficients uniform in [0, q) by rejection sampling 16-bit candidates; q must be in [2, 65536]
+    void fill_uniform(int32_t* out, size_t count, int q);
+
+    // Fills out with centered binomial values in [-eta, eta]: popcount of eta bits minus popcount of the next eta bits.
+    // eta = 5 has the same distribution as binomial(10, 0.5) - 5; eta must be in [1, 16]
+    void fill_centered_binomial(int32_t* out, size_t count, int eta);
+
+    // Per-thread sampler over RAND_bytes. Buffered bytes are dropped in a forked child so
+    // parent and child never hand out the same randomness; forks are counted by a pthread_atfork
+    // handler, so the check costs no system call.
+    static Sampler& thread_local_instance();
+
+private:
+    // Reads the next 64 random bits and wipes them from the block, like fill_bytes
+    uint64_t next_word();
+
+    // Replaces the block with fresh bytes from the source
+    void refill();
+
+    SamplerSource src;  // Randomness source
+    evp_cipher_ctx_st* cipher;  // AES-256-CTR context, null for the system source
+    size_t offset;  // Next unread byte of block
+    uint64_t generation;  // Fork count of the process the buffered bytes were drawn in
+    alignas(64) std::array<uint8_t, kBlockBytes> block;  // Buffered random bytes
+};
+
+}  // namespace lattice_crypto
+
+#endif  // SAMPLER_H
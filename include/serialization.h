@@ -0,0 +1,80 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "polynomial.h"
+
+namespace lattice_crypto {
+
+// Binary format shared by keys and ciphertexts, all integers little-endian:
+//
+//   offset  size  field
+//   0       4     magic "CRLW"
+//   4       1     format version (kSerializationVersion)
+//   5       1     BlobType
+//   6       1     bits per coefficient, ceil(log2 q)
+//   7       1     number of polynomials that follow
+//   8       4     ring degree n
+//   12      4     modulus q
+//   16      ...   each polynomial's n coefficients packed LSB-first at 'bits' bits, padded to a byte
+//
+// For n = 512, q = 12289 a coefficient takes 14 bits, so a ciphertext is 1808 bytes instead of 4096.
+
+// Current format version; readers reject any other
+constexpr uint8_t kSerializationVersion = 1;
+
+// Bytes before the first packed polynomial
+constexpr size_t kSerializedHeaderBytes = 16;
+
+// What a serialized blob holds
+enum class BlobType : uint8_t {
+    public_key = 1,  // (a, b)
+    secret_key = 2,  // s
+    ciphertext = 3,  // (c1, c2)
+};
+
+// Header fields of a serialized blob
+struct BlobHeader {
+    BlobType type;
+    int bits;
+    int polynomials;
+    int n;
+    int q;
+};
+
+// Bits needed for a coefficient in [0, q), i.e. ceil(log2 q)
+int coefficient_bits(int q);
+
+// Bytes taken by n coefficients packed at the given width
+size_t packed_size(size_t n, int bits);
+
+// Packs n coefficients, each below 2^bits, LSB-first into packed_size(n, bits) bytes
+void pack_coefficients(const int32_t* in, size_t n, int bits, uint8_t* out);
+
+// Unpacks n coefficients of the given width from packed_size(n, bits) bytes
+void unpack_coefficients(const uint8_t* in, size_t n, int bits, int32_t* out);
+
+// Bytes taken by a blob of count polynomials of n coefficients modulo q
+size_t serialized_size(size_t n, int q, int count);
+
+// Serializes the polynomials of one blob, each n coefficients in [0, q)
+std::string serialize_polynomials(BlobType type, int q, size_t n, const std::vector<const int32_t*>& polynomials);
+
+// Same, into serialized_size(n, q, count) bytes at out
+void serialize_polynomials_into(BlobType type, int q, size_t n, const int32_t* const* polynomials, int count, uint8_t* out);
+
+// Parses a blob of the expected type. Throws std::invalid_argument on a bad magic, version, type or length,
+// or on a coefficient outside [0, q).
+std::vector<RingElement> deserialize_polynomials(std::string_view data, BlobType expected, BlobHeader* header = nullptr);
+
+// Parses a blob that must hold exactly count polynomials for (n, q) into existing elements of size n; throws
+// std::invalid_argument like deserialize_polynomials, and also when the blob was made for other parameters
+void deserialize_polynomials_into(std::string_view data, BlobType expected, size_t n, int q, RingElement* const* out, int count);
+
+}  // namespace lattice_crypto
+
+#endif  // SERIALIZATION_H
@@ -0,0 +1,116 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ring_lwe.h"
+
+namespace lattice_crypto {
+
+class RingLWECrypto;
+
+// Streaming encryption of payloads of any length and content.
+//
+// The plaintext is cut into blocks of max_plaintext_size() - kStreamFrameBytes bytes. Each block is encrypted as one
+// ciphertext whose plaintext starts with a little-endian frame:
+//
+//   offset  size  field
+//   0       2     frame word: the low 15 bits hold the number of payload bytes, bit 15 marks the final block
+//   2       4     block index, counting from 0
+//   6       4     stream nonce, drawn at random once per stream and repeated in every block
+//
+// The stream is the concatenation of the ciphertexts in the serialization.h format, so every block has the same size
+// and binary data, including 0x00 and 0xff, survives. DecryptStream rejects a block whose index is out of sequence
+// or whose nonce differs from the first block's, so reordered, dropped, repeated or spliced blocks are caught.
+//
+// Ring-LWE ciphertexts are malleable, though: someone who knows the plaintext of a block can flip its bits, frame
+// included, without the keys. The frame guards against accidents and naive splicing, not against a forger. Streams
+// provide confidentiality only; where integrity matters, seal the data with hybrid_encrypt (hybrid.h), whose
+// AES-GCM tag authenticates every byte.
+//
+// Blocks are processed in batches on the shared thread pool, so sampling, transforms and packing of different
+// blocks overlap across cores. A stream holds at most one batch of input and reuses its buffers, so memory stays
+// constant however long the payload is. A stream object is not itself thread-safe.
+
+// Blocks buffered and processed together by default
+constexpr size_t kStreamBatchBlocks = 64;
+
+// Frame bytes at the start of every block plaintext
+constexpr size_t kStreamFrameBytes = 10;
+
+// EncryptStream turns plaintext chunks into a ciphertext stream
+class EncryptStream {
+public:
+    // Encrypts with the keys of crypto, which must outlive the stream
+    explicit EncryptStream(RingLWECrypto& crypto, size_t batch_blocks = kStreamBatchBlocks);
+
+    // Takes the next plaintext chunk and appends the ciphertext of every completed batch to out. Throws
+    // std::length_error once the stream would need more than 2^32 blocks.
+    void update(std::string_view plaintext, std::string& out);
+
+    // Encrypts what is left as the final block and appends it to out; the stream cannot be updated afterwards
+    void finalize(std::string& out);
+
+    // Plaintext bytes carried by one block
+    size_t payload_size() const { return payload; }
+
+    // Ciphertext bytes of one block
+    size_t block_size() const { return block_bytes; }
+
+private:
+    // Encrypts the buffered plaintext; with final set, the last block carries the final flag
+    void encrypt_pending(bool final, std::string& out);
+
+    RingLWEEngine& engine;  // Engine of the parameter set
+    size_t capacity;  // Plaintext bytes per ciphertext, frame word included
+    size_t payload;  // Plaintext bytes per block
+    size_t block_bytes;  // Serialized ciphertext bytes per block
+    size_t batch_blocks;  // Blocks per batch
+    std::string pending;  // Plaintext not yet encrypted, at most one batch
+    std::string framed;  // Framed block plaintexts of the current batch
+    std::vector<Ciphertext> ciphertexts;  // Ciphertexts of the current batch
+    uint32_t nonce;  // Stream nonce written into every block
+    uint64_t next_block;  // Index of the next block to encrypt
+    bool finished;  // True once finalize has run
+};
+
+// DecryptStream turns a ciphertext stream back into the plaintext
+class DecryptStream {
+public:
+    // Decrypts with the keys of crypto, which must outlive the stream
+    explicit DecryptStream(RingLWECrypto& crypto, size_t batch_blocks = kStreamBatchBlocks);
+
+    // Takes the next chunk of the ciphertext stream and appends the plaintext of every completed batch to out.
+    // Throws std::invalid_argument on a malformed or out-of-sequence block, or on data after the final block.
+    void update(std::string_view ciphertext, std::string& out);
+
+    // Decrypts what is left and appends it to out. Throws std::invalid_argument when the stream ends inside a
+    // block or before its final block.
+    void finalize(std::string& out);
+
+    // Ciphertext bytes of one block
+    size_t block_size() const { return block_bytes; }
+
+private:
+    // Decrypts the buffered whole blocks
+    void decrypt_pending(std::string& out);
+
+    RingLWEEngine& engine;  // Engine of the parameter set
+    size_t capacity;  // Plaintext bytes per ciphertext, frame word included
+    size_t payload;  // Plaintext bytes per block
+    size_t block_bytes;  // Serialized ciphertext bytes per block
+    size_t batch_blocks;  // Blocks per batch
+    std::string pending;  // Ciphertext bytes not yet decrypted, at most one batch
+    std::string slots;  // Decrypted block plaintexts of the current batch
+    std::vector<Ciphertext> ciphertexts;  // Parsed ciphertexts of the current batch
+    uint32_t nonce;  // Stream nonce taken from the first block
+    uint64_t next_block;  // Index the next block must carry
+    bool finished;  // True once the final block has been decrypted
+};
+
+}  // namespace lattice_crypto
+
+#endif  // STREAM_H
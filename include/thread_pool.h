@@ -0,0 +1,69 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+namespace lattice_crypto {
+
+// ThreadPool runs index ranges on a fixed set of workers with work stealing. Each worker owns a deque;
+// it pops its own tasks from the front and, when empty, steals from the back of the others, so an uneven
+// batch (long and short messages mixed) still keeps every core busy.
+class ThreadPool {
+public:
+    // Starts the given number of workers; 0 means one per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+
+    // Stops and joins the workers; tasks still queued are dropped
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of workers
+    size_t size() const { return threads.size(); }
+
+    // Runs body(i) for every i in [0, count) across the workers and blocks until all are done.
+    // The first exception thrown by body is rethrown here once the whole range has finished.
+    // In a forked child, where the workers do not exist, the range runs inline on the caller.
+    void parallel_for(size_t count, const std::function<void(size_t)>& body);
+
+    // Process-wide pool sized to the hardware, started on first use. A forked child inherits none of the parent's
+    // workers, so the first call in the child starts a fresh pool; the parent's copy is abandoned, not joined.
+    static ThreadPool& shared();
+
+private:
+    using Task = std::function<void()>;
+
+    // One worker's queue
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Worker loop for queue 'index'
+    void run(size_t index);
+
+    // Pops from queue 'index', or steals from another queue; false when every queue is empty
+    bool next_task(size_t index, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;  // One queue per worker
+    std::vector<std::thread> threads;  // Workers
+    std::mutex wake_mutex;  // Guards sleeping workers
+    std::condition_variable wake;  // Signals new work or shutdown
+    std::atomic<size_t> queued{0};  // Tasks pushed but not yet taken
+    bool stopping = false;  // Set once by the destructor
+    pid_t owner;  // Process whose threads these are
+};
+
+}  // namespace lattice_crypto
+
+#endif  // THREAD_POOL_H
@@ -0,0 +1,64 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "polynomial.h"
+
+namespace lattice_crypto {
+
+// Workspace is a bump arena for the transient polynomials of ring operations. Buffers are carved out of 64-byte
+// aligned chunks that are kept between operations, so once a thread has run an operation, running it again
+// allocates nothing. Every operation opens a Scope, and everything taken inside it is released when it ends;
+// scopes over secrets release with Release::wipe, so nothing they held outlives them in the reused chunks.
+// A Workspace is not thread-safe; use thread_local_instance() for one per thread.
+class Workspace {
+public:
+    // Coefficients in a chunk, unless a single request needs more
+    static constexpr size_t kChunkCoefficients = 16 * 1024;
+
+    // What a Scope does with its buffers when it ends
+    enum class Release {
+        rewind,  // Only rewind the bump pointer; for public operands
+        wipe,    // Cleanse everything taken inside the scope first; for secrets and anything derived from them
+    };
+
+    // Marks the workspace on construction and releases everything taken since on destruction; scopes nest
+    class Scope {
+    public:
+        explicit Scope(Workspace& workspace, Release release = Release::rewind);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Workspace& workspace;  // Arena being marked
+        size_t chunk;  // Chunk in use when the scope opened
+        size_t used;  // Coefficients used in that chunk
+        Release release;  // Whether to cleanse on release
+    };
+
+    Workspace() = default;
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+
+    // Returns count 64-byte aligned coefficients of scratch, valid until the enclosing Scope ends; contents are undefined
+    int32_t* take(size_t count);
+
+    // Coefficients reserved across all chunks
+    size_t reserved() const;
+
+    // Per-thread workspace used by the ring operations
+    static Workspace& thread_local_instance();
+
+private:
+    std::vector<RingElement::Storage> chunks;  // Aligned chunks, never shrunk
+    size_t current = 0;  // Chunk the next request is served from
+    size_t used = 0;  // Coefficients used in the current chunk
+};
+
+}  // namespace lattice_crypto
+
+#endif  // WORKSPACE_H
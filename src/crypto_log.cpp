@@ -0,0 +1,249 @@
+#include "crypto_log.h"  // Include the header file for declarations
+#include "mpmc_queue.h"  // Lock-free queue between callers and the writer
+#include "polynomial.h"  // For RingElement
+#include "ring_key.h"  // For RingKey
+#include <atomic>  // For std::atomic
+#include <charconv>  // For std::to_chars
+#include <chrono>  // For timestamps
+#include <algorithm>  // For std::min
+#include <condition_variable>  // For waking the writer
+#include <cstdio>  // For FILE and snprintf
+#include <cstdlib>  // For std::atexit
+#include <cstring>  // For std::memcpy
+#include <ctime>  // For gmtime_r
+#include <mutex>  // For std::mutex
+#include <stdexcept>  // For std::runtime_error
+#include <thread>  // For the writer thread
+
+#if __has_include(<filesystem>) // Check if filesystem is available
+  #include <filesystem> // For C++17 filesystem support
+  namespace fs = std::filesystem; // Alias for filesystem namespace
+#elif __has_include(<experimental/filesystem>) // Check if experimental filesystem is available
+  #include <experimental/filesystem> // For C++17 experimental filesystem support
+  namespace fs = std::experimental::filesystem; // Alias for filesystem namespace
+#else // No filesystem support
+  #error "No filesystem support" // Error message
+#endif // End of filesystem check
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+constexpr size_t kLogQueueRecords = 4096; // Records buffered between callers and the writer
+
+// One queued record
+struct LogEntry { // Fixed size, so queueing never allocates
+    LogLevel level; // Severity
+    uint32_t thread; // Small per-thread number
+    int64_t time_ns; // Wall-clock time since the epoch
+    uint32_t length; // Bytes used in text
+    char text[kLogMessageBytes]; // Message
+};
+
+// Name written for each level
+const char* level_name(LogLevel level) { // Function to name a level
+    switch (level) { // Pick the name
+        case LogLevel::trace: return "TRACE"; // Trace
+        case LogLevel::debug: return "DEBUG"; // Debug
+        case LogLevel::info: return "INFO"; // Info
+        case LogLevel::warn: return "WARN"; // Warning
+        case LogLevel::error: return "ERROR"; // Error
+        default: return "OFF"; // Not a record level
+    }
+}
+
+// Small number identifying the calling thread in the log
+uint32_t thread_number() { // Function to number threads
+    static std::atomic<uint32_t> next{1}; // Next number to hand out
+    thread_local uint32_t number = next.fetch_add(1); // Assigned on first record
+    return number; // Return the number
+}
+
+// Queue, writer thread and file behind the public functions
+class LogBackend { // Process-wide logger
+public:
+    MpmcQueue<LogEntry> queue{kLogQueueRecords}; // Records waiting for the writer
+    std::atomic<bool> open{false}; // True while a file is open
+    std::atomic<int> level{static_cast<int>(LogLevel::info)}; // Runtime level
+    std::atomic<uint64_t> pushed{0}; // Records queued
+    std::atomic<uint64_t> written{0}; // Records written
+    std::atomic<uint64_t> dropped{0}; // Records lost to a full queue
+    std::atomic<uint32_t> pushing{0}; // Callers between their open check and the end of their push
+    std::mutex control_mutex; // Serializes open and close
+    std::mutex wake_mutex; // Guards the writer's sleep
+    std::condition_variable wake; // Wakes the writer
+    std::condition_variable drained; // Wakes flush_log
+    bool stopping = false; // Asks the writer to exit
+    std::thread writer; // Background writer
+    FILE* file = nullptr; // Open log file
+
+    // Writer loop: drain, write, flush once per burst, then sleep
+    void run() { // Function run by the writer thread
+        LogEntry entry; // Record being written
+        while (true) { // Until stopped
+            bool wrote = false; // Whether this pass wrote anything
+            while (queue.try_pop(entry)) { // Drain everything queued
+                write(entry); // Format and write
+                written.fetch_add(1); // Count it
+                wrote = true; // Flush below
+            }
+            std::unique_lock<std::mutex> lock(wake_mutex); // Coordinate with flush_log and close_log
+            if (wrote) { // Burst finished
+                std::fflush(file); // One flush per burst instead of one per line
+                drained.notify_all(); // Wake flush_log
+                continue; // Look for more
+            }
+            if (stopping && written.load() == pushed.load()) break; // Everything written
+            wake.wait_for(lock, std::chrono::milliseconds(50)); // Sleep until woken or the next poll
+        }
+        std::fflush(file); // Final flush
+    }
+
+    // Formats one record as a line of the log file
+    void write(const LogEntry& entry) { // Function to write a record
+        std::time_t seconds = static_cast<std::time_t>(entry.time_ns / 1000000000); // Whole seconds
+        int millis = static_cast<int>((entry.time_ns / 1000000) % 1000); // Milliseconds
+        std::tm utc; // Broken-down time
+        gmtime_r(&seconds, &utc); // UTC, thread-safe
+        char stamp[32]; // Timestamp text
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &utc); // Date and time
+        std::fprintf(file, "%s.%03d %-5s [%u] %.*s\n", stamp, millis, level_name(entry.level), entry.thread,
+                     static_cast<int>(entry.length), entry.text); // Buffered write
+    }
+};
+
+// The backend is never destroyed, so records made during static destruction stay safe; close_log runs at exit
+LogBackend& backend() { // Function to get the logger
+    static LogBackend* instance = new LogBackend(); // Created on first use
+    return *instance; // Return the logger
+}
+
+} // End of anonymous namespace
+
+void open_log(const std::string& path) { // Function to open the log file
+    LogBackend& log = backend(); // Logger
+    close_log(); // Replace any log already open
+    std::lock_guard<std::mutex> control(log.control_mutex); // One open or close at a time
+    FILE* file = std::fopen(path.c_str(), "a"); // Append like before
+    if (file == nullptr) { // Check the file opened
+        throw std::runtime_error("Failed to open log file " + path); // Throw runtime error
+    }
+    log.file = file; // Writer output
+    log.stopping = false; // Writer keeps running
+    log.writer = std::thread(&LogBackend::run, &log); // Start the writer
+    log.open.store(true); // Accept records
+    static bool registered = (std::atexit(close_log), true); // Drain the queue at exit
+    (void)registered; // Only needed once
+}
+
+void init_logging() { // Function to initialize logging
+    try { // Try block to handle exceptions
+        fs::create_directories("logs"); // Ensure log directory exists
+    } catch (const fs::filesystem_error& e) { // Catch filesystem errors
+        throw std::runtime_error(std::string("Filesystem error: ") + e.what()); // Throw runtime error
+    }
+    open_log("logs/crypto_log.txt"); // Start logging to a file inside the logs directory
+    CRYPTO_LOG(info) << "Logging started."; // Log the start of logging
+}
+
+void close_log() { // Function to close the log file
+    LogBackend& log = backend(); // Logger
+    std::lock_guard<std::mutex> control(log.control_mutex); // One open or close at a time
+    if (!log.open.exchange(false)) return; // Nothing open; new records are refused from here on
+    while (log.pushing.load() != 0) std::this_thread::yield(); // Callers that saw the log open finish their push first
+    {
+        std::lock_guard<std::mutex> lock(log.wake_mutex); // Publish the stop flag
+        log.stopping = true; // Ask the writer to finish; pushed no longer moves, so its drain is complete
+    }
+    log.wake.notify_one(); // Wake the writer
+    log.writer.join(); // Wait until the queue is drained
+    std::fclose(log.file); // Close the file
+    log.file = nullptr; // No file open
+}
+
+void flush_log() { // Function to wait for queued records
+    LogBackend& log = backend(); // Logger
+    const uint64_t target = log.pushed.load(); // Records queued so far
+    std::unique_lock<std::mutex> lock(log.wake_mutex); // Coordinate with the writer
+    log.wake.notify_one(); // Do not wait for the next poll
+    log.drained.wait(lock, [&] { return log.written.load() >= target || !log.open.load(); }); // Until they are written
+}
+
+void set_log_level(LogLevel level) { // Function to set the runtime level
+    backend().level.store(static_cast<int>(level)); // Takes effect immediately
+}
+
+LogLevel log_level() { // Function to get the runtime level
+    return static_cast<LogLevel>(backend().level.load()); // Current level
+}
+
+bool log_enabled(LogLevel level) { // Function to check a level
+    LogBackend& log = backend(); // Logger
+    return log.open.load(std::memory_order_relaxed) && static_cast<int>(level) >= log.level.load(std::memory_order_relaxed); // Open and at or above the level
+}
+
+uint64_t dropped_log_records() { // Function to count dropped records
+    return backend().dropped.load(); // Records lost to a full queue
+}
+
+LogRecord::~LogRecord() { // Destructor queueing the record
+    LogBackend& log = backend(); // Logger
+    LogEntry entry; // Record to queue
+    entry.level = level; // Severity
+    entry.thread = thread_number(); // Calling thread
+    entry.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count(); // Wall-clock time
+    entry.length = static_cast<uint32_t>(length); // Message size
+    std::memcpy(entry.text, text, length); // Message
+    log.pushing.fetch_add(1); // Announced before the open check, so close_log waits for this push or this check sees it closed
+    if (!log.open.load()) { // Closed since log_enabled; the writer may already have drained the queue
+        log.pushing.fetch_sub(1); // Done
+        return; // Discard it rather than leave it for the next file
+    }
+    if (log.queue.try_push(entry)) { // Never block the caller
+        log.pushed.fetch_add(1); // Queued
+    } else { // Full
+        log.dropped.fetch_add(1, std::memory_order_relaxed); // Count the loss instead
+    }
+    log.pushing.fetch_sub(1); // Done
+}
+
+LogRecord& LogRecord::append(const char* data, size_t size) { // Function to append raw text
+    size_t take = std::min(size, kLogMessageBytes - length); // Truncate at the buffer end
+    std::memcpy(text + length, data, take); // Copy
+    length += take; // Advance
+    return *this; // Allow chaining
+}
+
+LogRecord& LogRecord::append_signed(long long value) { // Function to append a signed integer
+    char digits[24]; // Enough for any long long
+    auto result = std::to_chars(digits, digits + sizeof(digits), value); // Format without allocating
+    return append(digits, static_cast<size_t>(result.ptr - digits)); // Append the digits
+}
+
+LogRecord& LogRecord::append_unsigned(unsigned long long value) { // Function to append an unsigned integer
+    char digits[24]; // Enough for any unsigned long long
+    auto result = std::to_chars(digits, digits + sizeof(digits), value); // Format without allocating
+    return append(digits, static_cast<size_t>(result.ptr - digits)); // Append the digits
+}
+
+LogRecord& LogRecord::operator<<(const char* value) { return append(value, std::strlen(value)); } // C string
+LogRecord& LogRecord::operator<<(const std::string& value) { return append(value.data(), value.size()); } // String
+LogRecord& LogRecord::operator<<(char value) { return append(&value, 1); } // Single character
+LogRecord& LogRecord::operator<<(bool value) { return value ? append("true", 4) : append("false", 5); } // Boolean
+
+LogRecord& LogRecord::operator<<(double value) { // Function to append a floating-point value
+    char digits[32]; // Formatted value
+    int size = std::snprintf(digits, sizeof(digits), "%g", value); // Shortest general form
+    return append(digits, size > 0 ? static_cast<size_t>(size) : 0); // Append the digits
+}
+
+LogRecord& LogRecord::operator<<(const RingElement& element) { // Ring elements are never written out
+    return *this << "<ring element n=" << element.size() << ", redacted>"; // Placeholder with the shape only
+}
+
+LogRecord& LogRecord::operator<<(const RingKey& key) { // Keys are never written out
+    return *this << "<key n=" << key.size() << ", redacted>"; // Placeholder with the shape only
+}
+
+}  // namespace lattice_crypto
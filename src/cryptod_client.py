@@ -0,0 +1,213 @@
+# cryptod_client.py
+# Thin client for creed_cryptod, the native daemon that holds the lattice keys and serves encryption to every
+# process on the host. The wire format is described in include/cryptod_protocol.h; ciphertexts are the bytes of
+# RingLWECrypto.to_bytes, so they can be stored as-is or turned back into a ciphertext with RingLWECrypto.from_bytes.
+import os
+import selectors
+import socket
+import stat
+import struct
+
+# Opcodes, as in CryptodOpcode
+PING = 0
+PUBLIC_KEY = 1
+ENCRYPT = 2
+DECRYPT = 3
+ENCRYPT_BATCH = 4
+DECRYPT_BATCH = 5
+METRICS = 6
+
+# Statuses, as in CryptodStatus
+OK = 0
+BAD_REQUEST = 1
+FAILED = 2
+
+_HEADER = struct.Struct('<IIB')  # frame length, request id, opcode or status
+_U32 = struct.Struct('<I')
+_SEND_CHUNK = 65536  # bytes handed to one non-blocking send while pipelining
+
+_PEER_CREDENTIALS = struct.Struct('3i')  # pid, uid, gid as SO_PEERCRED returns them
+
+def default_socket_path():
+    """Socket the daemon listens on by default: creed_cryptod.sock in $XDG_RUNTIME_DIR or, without one, in
+    /tmp/creed-<euid>, which is created with mode 0700. Raises PermissionError when that directory is not a directory
+    owned by this user and closed to everyone else, as default_cryptod_socket_path does."""
+    runtime = os.environ.get('XDG_RUNTIME_DIR')
+    if runtime:
+        return os.path.join(runtime, 'creed_cryptod.sock')
+    uid = os.geteuid()
+    directory = f'/tmp/creed-{uid}'
+    try:
+        os.mkdir(directory, 0o700)
+    except FileExistsError:
+        pass
+    info = os.lstat(directory)
+    if not stat.S_ISDIR(info.st_mode) or info.st_uid != uid or info.st_mode & 0o077:
+        raise PermissionError(f"{directory} is not a directory private to uid {uid}")
+    return os.path.join(directory, 'creed_cryptod.sock')
+
+class CryptodError(Exception):
+    """The daemon answered a request with an error."""
+    def __init__(self, status, message):
+        super().__init__(message)
+        self.status = status
+
+def _pack_batch(items):
+    parts = [_U32.pack(len(items))]
+    for item in items:
+        parts.append(_U32.pack(len(item)))
+        parts.append(bytes(item))
+    return b''.join(parts)
+
+def _unpack_batch(payload):
+    count, = _U32.unpack_from(payload, 0)
+    offset, items = 4, []
+    for _ in range(count):
+        length, = _U32.unpack_from(payload, offset)
+        offset += 4
+        items.append(payload[offset:offset + length])
+        offset += length
+    return items
+
+class CryptodClient:
+    """One connection to creed_cryptod. Not thread-safe; give each thread its own client.
+    The connection is refused unless the daemon runs as this user or as root, so a socket planted by another user
+    never sees a plaintext."""
+
+    def __init__(self, path=None, timeout=None):
+        self.path = path or os.environ.get('CREED_CRYPTOD_SOCKET') or default_socket_path()
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.settimeout(timeout)
+        self.sock.connect(self.path)
+        _, uid, _ = _PEER_CREDENTIALS.unpack(
+            self.sock.getsockopt(socket.SOL_SOCKET, socket.SO_PEERCRED, _PEER_CREDENTIALS.size))
+        if uid != os.geteuid() and uid != 0:
+            self.sock.close()
+            raise PermissionError(f"{self.path} is served by uid {uid}, not by this user or root")
+        self.buffer = bytearray()
+        self.next_id = 0
+
+    def close(self):
+        self.sock.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def ping(self):
+        self._call(PING, b'')
+
+    def public_key(self):
+        """Public key in the format of RingLWECrypto.public_key_bytes."""
+        return self._call(PUBLIC_KEY, b'')
+
+    def encrypt(self, plaintext):
+        """Encrypts one plaintext of at most max_plaintext_size bytes; returns the serialized ciphertext.
+        Decryption ends a plaintext at its first 0x00 or 0xff byte, so the daemon rejects plaintexts holding either
+        with BAD_REQUEST; seal binary data with RingLWECrypto.hybrid_encrypt instead."""
+        return self._call(ENCRYPT, _as_bytes(plaintext))
+
+    def decrypt(self, ciphertext):
+        """Decrypts one serialized ciphertext to bytes."""
+        return self._call(DECRYPT, bytes(ciphertext))
+
+    def encrypt_batch(self, plaintexts):
+        """Encrypts every plaintext in one request; the daemon spreads them over its workers. Each plaintext follows
+        the rules of encrypt, and one rejected item fails the whole request."""
+        return _unpack_batch(self._call(ENCRYPT_BATCH, _pack_batch([_as_bytes(p) for p in plaintexts])))
+
+    def decrypt_batch(self, ciphertexts):
+        """Decrypts every serialized ciphertext in one request."""
+        return _unpack_batch(self._call(DECRYPT_BATCH, _pack_batch(ciphertexts)))
+
+    def metrics(self):
+        """The daemon's counters and latency histograms in the Prometheus text format."""
+        return self._call(METRICS, b'').decode('utf-8')
+
+    def pipeline(self, requests):
+        """Sends every (opcode, payload) request without waiting for the responses, so the daemon can batch them.
+        Responses are read while the requests are still being written: the daemon stops reading a client that
+        leaves too much unread, so sending everything first would deadlock on a long pipeline.
+        Returns the response payloads in request order; raises CryptodError for the first failed request
+        after reading them all."""
+        ids = []
+        frames = []
+        for opcode, payload in requests:
+            request_id = self._take_id()
+            ids.append(request_id)
+            frames.append(_HEADER.pack(5 + len(payload), request_id, opcode) + bytes(payload))
+        data = memoryview(b''.join(frames))
+        responses = []
+        sent = 0
+        with selectors.DefaultSelector() as selector:
+            selector.register(self.sock, selectors.EVENT_READ | selectors.EVENT_WRITE)
+            while sent < len(data):
+                ready = selector.select(self.sock.gettimeout())
+                if not ready:
+                    raise TimeoutError("creed_cryptod stopped reading the pipeline")
+                events = ready[0][1]
+                if events & selectors.EVENT_READ:
+                    self._receive(socket.MSG_DONTWAIT)
+                    while len(responses) < len(ids):
+                        response = self._pop_frame(ids[len(responses)])
+                        if response is None:
+                            break
+                        responses.append(response)
+                if events & selectors.EVENT_WRITE:
+                    try:
+                        sent += self.sock.send(data[sent:sent + _SEND_CHUNK], socket.MSG_DONTWAIT)
+                    except BlockingIOError:
+                        pass
+        responses += [self._read_frame(request_id) for request_id in ids[len(responses):]]
+        for status, payload in responses:
+            if status != OK:
+                raise CryptodError(status, payload.decode('utf-8', 'replace'))
+        return [payload for _, payload in responses]
+
+    def _take_id(self):
+        request_id = self.next_id
+        self.next_id = (self.next_id + 1) & 0xffffffff
+        return request_id
+
+    def _call(self, opcode, payload):
+        request_id = self._take_id()
+        self.sock.sendall(_HEADER.pack(5 + len(payload), request_id, opcode) + payload)
+        status, response = self._read_frame(request_id)
+        if status != OK:
+            raise CryptodError(status, response.decode('utf-8', 'replace'))
+        return response
+
+    def _read_frame(self, request_id):
+        while True:
+            response = self._pop_frame(request_id)
+            if response is not None:
+                return response
+            self._receive()
+
+    def _pop_frame(self, request_id):
+        """Takes the response to request_id off the buffer, or returns None while it is incomplete."""
+        if len(self.buffer) < 4:
+            return None
+        length, = _U32.unpack_from(self.buffer, 0)
+        if len(self.buffer) < 4 + length:
+            return None
+        _, response_id, status = _HEADER.unpack_from(self.buffer, 0)
+        payload = bytes(self.buffer[9:4 + length])
+        del self.buffer[:4 + length]
+        if response_id != request_id:
+            raise ConnectionError(f"creed_cryptod answered request {response_id}, expected {request_id}")
+        return status, payload
+
+    def _receive(self, flags=0):
+        try:
+            chunk = self.sock.recv(65536, flags)
+        except BlockingIOError:
+            return
+        if not chunk:
+            raise ConnectionError("creed_cryptod closed the connection")
+        self.buffer += chunk
+
+def _as_bytes(data):
+    return data.encode('utf-8') if isinstance(data, str) else bytes(data)
@@ -0,0 +1,105 @@
+#include "cryptod_protocol.h"  // Include the header file for declarations
+#include <cerrno>  // For errno
+#include <cstdlib>  // For getenv
+#include <stdexcept>  // For std::invalid_argument and std::runtime_error
+#include <string>  // For std::to_string
+#include <sys/stat.h>  // For mkdir and lstat
+#include <unistd.h>  // For geteuid
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+// Appends a 32-bit value, little-endian
+void append_u32(std::string& out, uint32_t value) { // Function to write a length or an id
+    const char bytes[4] = {static_cast<char>(value), static_cast<char>(value >> 8), static_cast<char>(value >> 16),
+                           static_cast<char>(value >> 24)}; // Low byte first
+    out.append(bytes, 4); // Append them
+}
+
+// Reads a 32-bit little-endian value; the caller checks that four bytes are there
+uint32_t read_u32(const char* in) { // Function to read a length or an id
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(in); // Bytes as unsigned values
+    return uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 | uint32_t(bytes[2]) << 16 | uint32_t(bytes[3]) << 24; // Low byte first
+}
+
+} // End of anonymous namespace
+
+void append_cryptod_header(std::string& out, uint32_t id, uint8_t code, size_t payload_size) { // Function to write a header
+    if (payload_size > UINT32_MAX - (kCryptodHeaderBytes - 4)) { // The length would not fit its 32-bit field
+        throw std::invalid_argument("Frame payload of " + std::to_string(payload_size) + " bytes is too large to frame."); // Throw instead of truncating
+    }
+    append_u32(out, static_cast<uint32_t>(kCryptodHeaderBytes - 4 + payload_size)); // Length of what follows
+    append_u32(out, id); // Request id
+    out.push_back(static_cast<char>(code)); // Opcode or status
+}
+
+void append_cryptod_frame(std::string& out, uint32_t id, uint8_t code, std::string_view payload) { // Function to write a frame
+    out.reserve(out.size() + kCryptodHeaderBytes + payload.size()); // One allocation at most
+    append_cryptod_header(out, id, code, payload.size()); // Header
+    out.append(payload.data(), payload.size()); // Payload
+}
+
+size_t parse_cryptod_frame(std::string_view data, CryptodFrame& frame, size_t max_frame_bytes) { // Function to read a frame
+    if (data.size() < 4) return 0; // Length not here yet
+    const size_t length = read_u32(data.data()); // Bytes after the length field
+    if (length < kCryptodHeaderBytes - 4 || length > max_frame_bytes - 4) { // Check the length before waiting for it
+        throw std::invalid_argument("Frame length " + std::to_string(length) + " is out of range."); // Throw invalid argument
+    }
+    if (data.size() < 4 + length) return 0; // Rest of the frame not here yet
+    frame.id = read_u32(data.data() + 4); // Request id
+    frame.code = static_cast<uint8_t>(data[8]); // Opcode or status
+    frame.payload = data.substr(kCryptodHeaderBytes, length - (kCryptodHeaderBytes - 4)); // Payload
+    return 4 + length; // Bytes consumed
+}
+
+size_t cryptod_batch_size(const std::vector<std::string>& items) { // Function to size a batch payload
+    size_t size = 4; // Item count
+    for (const std::string& item : items) size += 4 + item.size(); // Length and bytes of each item
+    return size; // Return the size
+}
+
+void append_cryptod_batch(std::string& out, const std::vector<std::string>& items) { // Function to write a batch payload
+    out.reserve(out.size() + cryptod_batch_size(items)); // One allocation at most
+    append_u32(out, static_cast<uint32_t>(items.size())); // Item count
+    for (const std::string& item : items) { // Loop through each item
+        append_u32(out, static_cast<uint32_t>(item.size())); // Its length
+        out.append(item); // Its bytes
+    }
+}
+
+std::vector<std::string_view> parse_cryptod_batch(std::string_view payload) { // Function to read a batch payload
+    if (payload.size() < 4) throw std::invalid_argument("Batch payload is missing its item count."); // Throw invalid argument
+    const size_t count = read_u32(payload.data()); // Items announced
+    if (count > (payload.size() - 4) / 4) throw std::invalid_argument("Batch item count exceeds the payload."); // Each item needs at least its length
+    std::vector<std::string_view> items; // Result
+    items.reserve(count); // One allocation
+    size_t offset = 4; // Start of the first item
+    for (size_t i = 0; i < count; ++i) { // Loop through each item
+        if (payload.size() - offset < 4) throw std::invalid_argument("Batch item " + std::to_string(i) + " is truncated."); // Length missing
+        const size_t length = read_u32(payload.data() + offset); // Item length
+        offset += 4; // Skip it
+        if (payload.size() - offset < length) throw std::invalid_argument("Batch item " + std::to_string(i) + " is truncated."); // Bytes missing
+        items.push_back(payload.substr(offset, length)); // View of the item
+        offset += length; // Next item
+    }
+    if (offset != payload.size()) throw std::invalid_argument("Batch payload has trailing bytes."); // Throw invalid argument
+    return items; // Return the items
+}
+
+std::string default_cryptod_socket_path() { // Function to pick the socket path
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR"); // Per-user runtime directory, when the session has one
+    if (runtime && *runtime) return std::string(runtime) + "/creed_cryptod.sock"; // Already private to this user
+    const uid_t uid = ::geteuid(); // Owner the directory must have
+    const std::string directory = "/tmp/creed-" + std::to_string(uid); // Per-user directory under the shared /tmp
+    if (::mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) { // Create it unless it is there
+        throw std::runtime_error("Cannot create " + directory + "."); // Throw runtime error
+    }
+    struct stat info; // What is at the path now, links not followed
+    if (::lstat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) || info.st_uid != uid || (info.st_mode & 077) != 0) { // Someone else may have planted it
+        throw std::runtime_error(directory + " is not a directory private to uid " + std::to_string(uid) + "."); // Throw runtime error
+    }
+    return directory + "/creed_cryptod.sock"; // Return the path
+}
+
+}  // namespace lattice_crypto
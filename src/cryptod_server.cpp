@@ -0,0 +1,495 @@
+#include "cryptod_server.h"  // Include the header file for declarations
+#include "crypto_log.h"  // Leveled asynchronous logging
+#include "lattice_crypto.h"  // For RingLWECrypto
+#include "metrics.h"  // For metrics_prometheus
+#include "serialization.h"  // For serialized_size
+#include <openssl/crypto.h>  // For OPENSSL_cleanse
+#include <cerrno>  // For errno
+#include <cstring>  // For strerror and memcpy
+#include <deque>  // For the per-connection queue of pending jobs
+#include <stdexcept>  // For std::runtime_error and std::invalid_argument
+#include <thread>  // For the dispatcher thread
+#include <sys/epoll.h>  // For epoll
+#include <sys/eventfd.h>  // For eventfd
+#include <sys/socket.h>  // For socket, bind, listen and accept4
+#include <sys/stat.h>  // For lstat and chmod
+#include <sys/un.h>  // For sockaddr_un
+#include <unistd.h>  // For close, read, write and unlink
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+constexpr int kMaxEvents = 64; // Events taken per epoll_wait
+constexpr size_t kReadChunk = 64 * 1024; // Bytes asked for per recv
+constexpr int kReadsPerEvent = 4; // recv calls per readable event, so one busy client cannot starve the others
+constexpr size_t kMaxBufferedOutput = size_t(16) << 20; // Unsent response bytes before the daemon stops reading from a client
+
+// Most items a batch may hold when each answer takes up to item_bytes, so the response fits in one frame
+size_t max_batch_items(size_t max_frame_bytes, size_t item_bytes) { // Function to bound a batch by its answer
+    const size_t fixed = kCryptodHeaderBytes + 4; // Header and item count
+    return max_frame_bytes < fixed ? 0 : (max_frame_bytes - fixed) / (4 + item_bytes); // Length and bytes of each answer
+}
+
+// Throws std::runtime_error naming the failed call and errno
+[[noreturn]] void throw_system_error(const std::string& what) { // Function to report a failed system call
+    throw std::runtime_error(what + ": " + std::strerror(errno)); // Throw runtime error
+}
+
+// Fills a socket address for path; throws std::runtime_error when the path does not fit
+sockaddr_un socket_address(const std::string& path) { // Function to build the address
+    sockaddr_un address{}; // Zeroed address
+    address.sun_family = AF_UNIX; // Local socket
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) { // Room for the terminating zero
+        throw std::runtime_error("Socket path must be 1 to " + std::to_string(sizeof(address.sun_path) - 1) + " bytes: " + path); // Throw runtime error
+    }
+    std::memcpy(address.sun_path, path.data(), path.size()); // Copy the path
+    return address; // Return the address
+}
+
+// Wipes a buffer that may have held plaintext
+void wipe(std::string& buffer) { // Function to clear secrets
+    if (!buffer.empty()) OPENSSL_cleanse(&buffer[0], buffer.size()); // Overwrite in place
+}
+
+} // End of anonymous namespace
+
+// Socket and buffers of one client; loop thread only
+struct CryptodServer::Connection {
+    int fd = -1; // Client socket
+    std::string in; // Bytes read but not yet parsed
+    std::string out; // Responses not yet sent
+    size_t out_offset = 0; // Bytes of out already sent
+    std::deque<std::shared_ptr<Job>> pending; // Requests not yet moved to out, in arrival order
+    uint32_t events = 0; // Events registered with epoll
+    bool read_closed = false; // The client has shut down its side
+    bool closed = false; // The socket is closed
+    bool flush_scheduled = false; // Already in the current collect_completed list
+
+    ~Connection() { // Destructor wiping the buffers
+        wipe(in); // Plaintexts of encrypt requests
+        wipe(out); // Plaintexts of decrypt responses
+    }
+
+    // True while the daemon reads more requests from this client
+    bool accepting(size_t max_pending) const { // Function to apply backpressure
+        return !read_closed && pending.size() < max_pending && out.size() - out_offset < kMaxBufferedOutput; // Within every limit
+    }
+};
+
+// One request and its response
+struct CryptodServer::Job {
+    std::shared_ptr<Connection> connection; // Client to answer
+    uint32_t id = 0; // Request id
+    uint8_t opcode = 0; // What the client asked for
+    std::string request; // Payload
+    std::vector<std::string_view> inputs; // Items of the payload; one for single requests
+    std::vector<std::string> outputs; // Result per item
+    std::mutex error_mutex; // Guards status and error, written by whichever worker fails first
+    CryptodStatus status = CryptodStatus::ok; // Outcome
+    std::string error; // Message of the first failure
+    bool done = false; // Response ready; loop thread only
+
+    ~Job() { // Destructor wiping plaintexts
+        wipe(request); // Plaintexts of encrypt requests
+        for (std::string& output : outputs) wipe(output); // Plaintexts of decrypt responses
+    }
+
+    // Records a failure; the first one is reported
+    void fail(CryptodStatus failure, const std::string& message) { // Function to record an error
+        std::lock_guard<std::mutex> lock(error_mutex); // Workers may fail concurrently
+        if (status != CryptodStatus::ok) return; // Keep the first failure
+        status = failure; // Outcome
+        error = message; // Message
+    }
+};
+
+CryptodServer::CryptodServer(RingLWECrypto& crypto, const CryptodServerOptions& options) // Constructor binding the socket
+    : crypto(crypto), // Keys shared by every request
+      options(options), // Limits and paths
+      path(options.socket_path.empty() ? default_cryptod_socket_path() : options.socket_path) { // Listening socket path
+    if (options.max_frame_bytes < kCryptodHeaderBytes || options.max_pending == 0) { // Check the limits
+        throw std::invalid_argument("Server limits must allow at least one frame header and one pending request."); // Throw invalid argument
+    }
+    if (options.max_frame_bytes - 4 > UINT32_MAX) { // The length field is 32 bits
+        throw std::invalid_argument("Server frame limit must fit the 32-bit frame length."); // Throw invalid argument
+    }
+    const sockaddr_un address = socket_address(path); // Address to bind
+    struct stat existing; // File already at the path
+    if (::lstat(path.c_str(), &existing) == 0) { // Something is there
+        if (!S_ISSOCK(existing.st_mode)) throw std::runtime_error(path + " exists and is not a socket."); // Never remove other files
+        int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0); // Probe for a live server
+        const bool live = probe >= 0 && ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0; // Someone answers
+        if (probe >= 0) ::close(probe); // Done probing
+        if (live) throw std::runtime_error("A server is already listening on " + path + "."); // Throw runtime error
+        ::unlink(path.c_str()); // Stale socket of a dead server
+    }
+
+    try { // Release whatever was opened when a later step fails
+        listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0); // Listening socket
+        if (listen_fd < 0) throw_system_error("socket"); // Check it
+        if (::bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) throw_system_error("bind " + path); // Create the file
+        struct stat bound; // The file bind created
+        if (::lstat(path.c_str(), &bound) != 0) throw_system_error("stat " + path); // Check it
+        socket_inode = static_cast<uint64_t>(bound.st_ino); // Remember which file is ours
+        if (::chmod(path.c_str(), options.socket_mode) != 0) throw_system_error("chmod " + path); // Restrict who may connect
+        if (::listen(listen_fd, SOMAXCONN) != 0) throw_system_error("listen"); // Start queueing connections
+        epoll_fd = ::epoll_create1(EPOLL_CLOEXEC); // Event loop
+        if (epoll_fd < 0) throw_system_error("epoll_create1"); // Check it
+        wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC); // Wake-up channel
+        if (wake_fd < 0) throw_system_error("eventfd"); // Check it
+        for (int fd : {listen_fd, wake_fd}) { // Both are watched for input
+            epoll_event event{}; // Registration
+            event.events = EPOLLIN; // Readable
+            event.data.fd = fd; // Identify it
+            if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) throw_system_error("epoll_ctl"); // Register it
+        }
+        workers.reset(new ThreadPool(options.workers)); // Threads running the crypto
+    } catch (...) { // Undo the partial setup
+        for (int fd : {wake_fd, epoll_fd, listen_fd}) if (fd >= 0) ::close(fd); // Close what was opened
+        if (socket_inode != 0) ::unlink(path.c_str()); // Remove the file bind created
+        throw; // Rethrow
+    }
+    CRYPTO_LOG(info) << "Crypto daemon listening on " << path << " with " << workers->size() << " workers"; // Log the setup
+}
+
+CryptodServer::~CryptodServer() { // Destructor releasing the socket
+    while (!connections.empty()) close_connection(connections.begin()->second); // Normally done by run()
+    struct stat current; // File now at the path
+    if (::lstat(path.c_str(), &current) == 0 && static_cast<uint64_t>(current.st_ino) == socket_inode) ::unlink(path.c_str()); // Only our own socket
+    ::close(wake_fd); // Wake-up channel
+    ::close(epoll_fd); // Event loop
+    ::close(listen_fd); // Listening socket
+}
+
+void CryptodServer::run() { // Event loop
+    std::thread dispatcher(&CryptodServer::dispatch, this); // Runs the rounds
+    epoll_event events[kMaxEvents]; // Ready events
+    while (!stopping.load()) { // Until stop()
+        const int ready = ::epoll_wait(epoll_fd, events, kMaxEvents, -1); // Sleep until something happens
+        if (ready < 0) { // Interrupted or broken
+            if (errno == EINTR) continue; // A signal; check stopping again
+            CRYPTO_LOG(error) << "epoll_wait failed: " << std::strerror(errno); // Log the failure
+            break; // Shut down
+        }
+        for (int i = 0; i < ready; ++i) { // Loop through each event
+            const int fd = events[i].data.fd; // Source
+            if (fd == listen_fd) { // New clients
+                accept_connections(); // Accept them
+                continue; // Next event
+            }
+            if (fd == wake_fd) { // stop() or a finished round
+                uint64_t signals; // eventfd counter, only read to reset it
+                ssize_t drained = ::read(wake_fd, &signals, sizeof(signals)); // Reset it
+                (void)drained; // Nothing to do if it was already reset
+                collect_completed(); // Send what is ready
+                continue; // Next event
+            }
+            auto found = connections.find(fd); // Client
+            if (found == connections.end()) continue; // Closed earlier in this iteration
+            std::shared_ptr<Connection> connection = found->second; // Keep it alive through the handlers
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) { // Gone both ways, so nothing more can be sent
+                close_connection(connection); // Drop it
+                continue; // Next event
+            }
+            if (events[i].events & EPOLLIN) read_connection(connection); // Requests arrived
+            if (!connection->closed && (events[i].events & EPOLLOUT)) flush_connection(connection); // Room to send
+            update_connection(connection); // Adjust the registration
+        }
+        if (!parsed.empty()) { // Hand the new requests to the dispatcher
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex); // Shared with the dispatcher
+                for (std::shared_ptr<Job>& job : parsed) if (!job->connection->closed) queued.push_back(std::move(job)); // Skip clients already gone
+            }
+            queue_ready.notify_one(); // Start a round unless one is running
+            parsed.clear(); // Start over
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex); // Shared with the dispatcher
+        dispatcher_stopping = true; // Finish what is queued, then exit
+    }
+    queue_ready.notify_one(); // Wake it
+    dispatcher.join(); // Wait for the last round
+    collect_completed(); // Send what the sockets take
+    while (!connections.empty()) close_connection(connections.begin()->second); // Close every client
+    CRYPTO_LOG(info) << "Crypto daemon on " << path << " stopped after " << request_count.load() << " requests"; // Log the shutdown
+}
+
+void CryptodServer::stop() { // Function to end run()
+    stopping.store(true); // Checked after every wake-up
+    const uint64_t one = 1; // eventfd increment
+    ssize_t written = ::write(wake_fd, &one, sizeof(one)); // Wake the loop; write is async-signal-safe
+    (void)written; // Already signalled if the counter is saturated
+}
+
+CryptodServerStats CryptodServer::stats() const { // Function to read the totals
+    CryptodServerStats totals; // Result
+    totals.connections = connection_count.load(); // Connections accepted
+    totals.requests = request_count.load(); // Requests answered
+    totals.batches = batch_count.load(); // Rounds run
+    return totals; // Return the totals
+}
+
+void CryptodServer::accept_connections() { // Function to accept new clients
+    while (true) { // Until the backlog is empty
+        const int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC); // Next client
+        if (fd < 0) { // Nothing more, or a failure
+            if (errno == EINTR || errno == ECONNABORTED) continue; // Try the next one
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return; // Backlog empty
+            CRYPTO_LOG(warn) << "accept failed: " << std::strerror(errno); // e.g. out of descriptors
+            return; // Done
+        }
+        ucred peer{}; // Credentials of the client process
+        socklen_t length = sizeof(peer); // Size of the credentials
+        if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &length) != 0 || (peer.uid != ::geteuid() && peer.uid != 0)) { // Other users may not use the keys
+            CRYPTO_LOG(warn) << "Rejected a connection from uid " << peer.uid; // Log the refusal
+            ::close(fd); // Drop it
+            continue; // Next client
+        }
+        std::shared_ptr<Connection> connection = std::make_shared<Connection>(); // Client state
+        connection->fd = fd; // Its socket
+        connection->events = EPOLLIN; // Start by reading
+        epoll_event event{}; // Registration
+        event.events = connection->events; // Readable
+        event.data.fd = fd; // Identify it
+        if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) { // Register it
+            CRYPTO_LOG(warn) << "epoll_ctl failed: " << std::strerror(errno); // Log the failure
+            ::close(fd); // Drop it
+            continue; // Next client
+        }
+        connections[fd] = connection; // Track it
+        connection_count.fetch_add(1); // Count it
+    }
+}
+
+void CryptodServer::read_connection(const std::shared_ptr<Connection>& connection) { // Function to read requests
+    for (int reads = 0; reads < kReadsPerEvent && connection->accepting(options.max_pending); ++reads) { // Bounded work per event
+        const size_t used = connection->in.size(); // Bytes already buffered
+        connection->in.resize(used + kReadChunk); // Room for the next chunk
+        const ssize_t got = ::recv(connection->fd, &connection->in[used], kReadChunk, 0); // Read it
+        connection->in.resize(used + (got > 0 ? static_cast<size_t>(got) : 0)); // Keep only what arrived
+        if (got > 0) { // Data
+            if (static_cast<size_t>(got) < kReadChunk) break; // Socket drained
+            continue; // Maybe more
+        }
+        if (got == 0) { // The client shut down its side; answer what it sent, then close
+            connection->read_closed = true; // Stop reading
+            break; // Done
+        }
+        if (errno == EINTR) continue; // Retry
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break; // Socket drained
+        close_connection(connection); // Reset or broken
+        return; // Done
+    }
+    parse_frames(connection); // Queue the complete frames
+}
+
+void CryptodServer::parse_frames(const std::shared_ptr<Connection>& connection) { // Function to split frames
+    size_t offset = 0; // Start of the next frame
+    while (!connection->closed && connection->pending.size() < options.max_pending) { // Leave the rest buffered under backpressure
+        CryptodFrame frame; // Next frame
+        size_t used; // Bytes it spans
+        try { // A bad length cannot be skipped over
+            used = parse_cryptod_frame(std::string_view(connection->in).substr(offset), frame, options.max_frame_bytes); // Parse it
+        } catch (const std::invalid_argument& e) { // Corrupt stream
+            CRYPTO_LOG(warn) << "Closing a connection after a protocol error: " << e.what(); // Log it
+            close_connection(connection); // Drop the client
+            return; // Done
+        }
+        if (used == 0) break; // Incomplete frame
+        std::shared_ptr<Job> job = std::make_shared<Job>(); // Request state
+        job->connection = connection; // Client to answer
+        job->id = frame.id; // Request id
+        job->opcode = frame.code; // Operation
+        job->request.assign(frame.payload.data(), frame.payload.size()); // Own the payload
+        connection->pending.push_back(job); // Answer in order
+        parsed.push_back(std::move(job)); // Dispatch after this iteration
+        offset += used; // Next frame
+    }
+    if (offset != 0) { // Drop the parsed bytes
+        OPENSSL_cleanse(&connection->in[0], offset); // They may be plaintexts
+        connection->in.erase(0, offset); // Shift the remainder down
+    }
+}
+
+void CryptodServer::flush_connection(const std::shared_ptr<Connection>& connection) { // Function to send responses
+    bool released = false; // Some pending request was answered
+    while (!connection->pending.empty() && connection->pending.front()->done) { // Answer in request order
+        append_response(connection->out, *connection->pending.front()); // Encode it
+        connection->pending.pop_front(); // Forget it
+        released = true; // Room for more requests
+    }
+    while (connection->out_offset < connection->out.size()) { // Until everything is sent or the socket is full
+        const ssize_t sent = ::send(connection->fd, connection->out.data() + connection->out_offset,
+                                    connection->out.size() - connection->out_offset, MSG_NOSIGNAL); // Write
+        if (sent > 0) { // Progress
+            connection->out_offset += static_cast<size_t>(sent); // Advance
+            continue; // Keep writing
+        }
+        if (sent < 0 && errno == EINTR) continue; // Retry
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break; // Socket full; wait for EPOLLOUT
+        close_connection(connection); // The client went away
+        return; // Done
+    }
+    if (connection->out_offset == connection->out.size()) { // Everything sent
+        wipe(connection->out); // It may have held plaintexts
+        connection->out.clear(); // Reuse the storage
+        connection->out_offset = 0; // Start over
+    }
+    if (released && !connection->in.empty()) parse_frames(connection); // Frames held back by backpressure
+}
+
+void CryptodServer::update_connection(const std::shared_ptr<Connection>& connection) { // Function to adjust epoll
+    if (connection->closed) return; // Nothing to adjust
+    if (connection->read_closed && connection->pending.empty() && connection->out_offset == connection->out.size()) { // All answered
+        close_connection(connection); // Finish the conversation
+        return; // Done
+    }
+    uint32_t wanted = 0; // Events to wait for
+    if (connection->accepting(options.max_pending)) wanted |= EPOLLIN; // More requests welcome
+    if (connection->out_offset < connection->out.size()) wanted |= EPOLLOUT; // Responses waiting for room
+    if (wanted == connection->events) return; // Already registered
+    epoll_event event{}; // Registration
+    event.events = wanted; // New interest
+    event.data.fd = connection->fd; // Identify it
+    if (::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection->fd, &event) != 0) { // Update it
+        close_connection(connection); // Cannot watch it any more
+        return; // Done
+    }
+    connection->events = wanted; // Remember it
+}
+
+void CryptodServer::close_connection(const std::shared_ptr<Connection>& client) { // Function to drop a client
+    std::shared_ptr<Connection> connection = client; // The argument may be the map entry erased below
+    if (connection->closed) return; // Already closed
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, nullptr); // Stop watching it
+    ::close(connection->fd); // Close the socket
+    connections.erase(connection->fd); // Forget it; the descriptor may be reused at once
+    connection->closed = true; // Jobs still running see this when they finish
+    connection->pending.clear(); // Their responses are dropped
+}
+
+void CryptodServer::collect_completed() { // Function to send finished work
+    JobList finished; // Jobs of the finished rounds
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex); // Shared with the dispatcher
+        finished.swap(completed); // Take them all
+    }
+    std::vector<std::shared_ptr<Connection>> touched; // Connections with new responses
+    for (const std::shared_ptr<Job>& job : finished) { // Loop through each job
+        job->done = true; // The mutex above ordered the workers' writes before this
+        Connection& connection = *job->connection; // Client
+        if (connection.closed || connection.flush_scheduled) continue; // Gone, or already listed
+        connection.flush_scheduled = true; // List it once
+        touched.push_back(job->connection); // Flush it below
+    }
+    for (const std::shared_ptr<Connection>& connection : touched) { // Loop through each client
+        connection->flush_scheduled = false; // Ready for the next round
+        if (!connection->closed) flush_connection(connection); // Send its responses
+        update_connection(connection); // Adjust the registration
+    }
+}
+
+void CryptodServer::dispatch() { // Dispatcher thread
+    JobList round; // Jobs of the current round
+    while (true) { // Until run() ends
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex); // Shared with the loop
+            queue_ready.wait(lock, [this] { return dispatcher_stopping || !queued.empty(); }); // Wait for work
+            if (queued.empty()) return; // Stopping with nothing left
+            round.swap(queued); // Everything queued since the last round
+        }
+        process(round); // Compute the responses
+        request_count.fetch_add(round.size()); // Count the requests
+        batch_count.fetch_add(1); // Count the round
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex); // Shared with the loop
+            completed.insert(completed.end(), round.begin(), round.end()); // Hand them back
+        }
+        const uint64_t one = 1; // eventfd increment
+        ssize_t written = ::write(wake_fd, &one, sizeof(one)); // Wake the loop
+        (void)written; // Already signalled if the counter is saturated
+        round.clear(); // Start over
+    }
+}
+
+void CryptodServer::process(JobList& round) { // Function to run one round
+    struct Task { // One item of one job
+        Job* job; // Owning job
+        size_t item; // Index into its inputs
+    };
+    std::vector<Task> tasks; // Every crypto item in the round
+    const RingLWEEngine& engine = crypto.engine(); // Parameter set
+    const size_t ciphertext_bytes = serialized_size(static_cast<size_t>(engine.degree()), engine.modulus(), 2); // Every encrypt answer
+    for (const std::shared_ptr<Job>& pointer : round) { // Loop through each job
+        Job& job = *pointer; // Request
+        try { // Malformed batches fail just this job
+            switch (static_cast<CryptodOpcode>(job.opcode)) { // Dispatch on the operation
+                case CryptodOpcode::ping: job.outputs.assign(1, std::string()); break; // Empty answer
+                case CryptodOpcode::public_key: job.outputs.assign(1, crypto.public_key_bytes()); break; // Packed (a, b)
+                case CryptodOpcode::metrics: job.outputs.assign(1, metrics_prometheus()); break; // Prometheus text
+                case CryptodOpcode::encrypt: // Fall through
+                case CryptodOpcode::decrypt: job.inputs.assign(1, job.request); break; // The payload is the item
+                case CryptodOpcode::encrypt_batch: // Fall through
+                case CryptodOpcode::decrypt_batch: { // Batch of items
+                    job.inputs = parse_cryptod_batch(job.request); // Split the items
+                    const size_t item_bytes = job.opcode == static_cast<uint8_t>(CryptodOpcode::encrypt_batch) ? ciphertext_bytes :
+                                              engine.max_plaintext_size(); // Largest answer per item
+                    if (job.inputs.size() > max_batch_items(options.max_frame_bytes, item_bytes)) { // Empty items ask for far more than they send
+                        throw std::invalid_argument("Batch of " + std::to_string(job.inputs.size()) + " items could answer with more than the " +
+                                                    std::to_string(options.max_frame_bytes) + "-byte frame limit."); // Throw invalid argument
+                    }
+                    break; // Within the limit
+                }
+                default: throw std::invalid_argument("Unknown opcode " + std::to_string(job.opcode) + "."); // Throw invalid argument
+            }
+        } catch (const std::invalid_argument& e) { // Bad request
+            job.fail(CryptodStatus::bad_request, e.what()); // Answer with the reason
+            continue; // Next job
+        }
+        if (job.inputs.empty()) continue; // Answered above
+        job.outputs.resize(job.inputs.size()); // One result per item
+        for (size_t i = 0; i < job.inputs.size(); ++i) tasks.push_back(Task{&job, i}); // Spread the items
+    }
+
+    workers->parallel_for(tasks.size(), [&](size_t t) { // Every item of the round in parallel
+        Job& job = *tasks[t].job; // Owning job
+        const size_t item = tasks[t].item; // Item index
+        const bool batch = job.opcode == static_cast<uint8_t>(CryptodOpcode::encrypt_batch) ||
+                           job.opcode == static_cast<uint8_t>(CryptodOpcode::decrypt_batch); // Errors name the item
+        try { // A failing item fails its job
+            if (job.opcode == static_cast<uint8_t>(CryptodOpcode::encrypt) || job.opcode == static_cast<uint8_t>(CryptodOpcode::encrypt_batch)) { // Encrypt
+                if (job.inputs[item].find_first_of(std::string_view("\0\xff", 2)) != std::string_view::npos) { // Decryption stops at the first padding byte
+                    throw std::invalid_argument("Plaintext contains a 0x00 or 0xff byte, which decryption reads as padding."); // Throw invalid argument
+                }
+                thread_local Ciphertext ciphertext; // Reused across items on this thread
+                crypto.encrypt_into(job.inputs[item], ciphertext); // Encrypt, drawing on the randomness pool when enabled
+                job.outputs[item] = crypto.to_bytes(ciphertext); // Packed ciphertext
+            } else { // Decrypt
+                crypto.decrypt_into(crypto.ciphertext_from_bytes(job.inputs[item]), job.outputs[item]); // Parse and decrypt
+            }
+        } catch (const std::invalid_argument& e) { // Oversized or binary plaintext, or foreign ciphertext
+            job.fail(CryptodStatus::bad_request, batch ? "Item " + std::to_string(item) + ": " + e.what() : std::string(e.what())); // Report it
+        } catch (const std::exception& e) { // Anything else
+            job.fail(CryptodStatus::failed, batch ? "Item " + std::to_string(item) + ": " + e.what() : std::string(e.what())); // Report it
+        }
+    });
+}
+
+void CryptodServer::append_response(std::string& out, const Job& job) { // Function to encode a response
+    if (job.status != CryptodStatus::ok) { // Failure
+        append_cryptod_frame(out, job.id, static_cast<uint8_t>(job.status), job.error); // Message as the payload
+        return; // Done
+    }
+    const CryptodOpcode opcode = static_cast<CryptodOpcode>(job.opcode); // Operation
+    if (opcode == CryptodOpcode::encrypt_batch || opcode == CryptodOpcode::decrypt_batch) { // Batch answer
+        append_cryptod_header(out, job.id, static_cast<uint8_t>(CryptodStatus::ok), cryptod_batch_size(job.outputs)); // Header
+        append_cryptod_batch(out, job.outputs); // Items
+        return; // Done
+    }
+    append_cryptod_frame(out, job.id, static_cast<uint8_t>(CryptodStatus::ok), job.outputs[0]); // Single answer
+}
+
+}  // namespace lattice_crypto
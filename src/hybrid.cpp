@@ -0,0 +1,130 @@
+#include "hybrid.h"  // Include the header file for declarations
+#include "lattice_crypto.h"  // For RingLWECrypto
+#include "sampler.h"  // Block-buffered random sampling
+#include "serialization.h"  // Bit-packed ciphertext format
+#include "crypto_log.h"  // Leveled asynchronous logging
+#include <openssl/crypto.h>  // For OPENSSL_cleanse
+#include <openssl/evp.h>  // For the AES-256-GCM cipher
+#include <algorithm>  // For std::min
+#include <climits>  // For INT_MAX
+#include <cstring>  // For std::memcmp and std::memcpy
+#include <stdexcept>  // For std::invalid_argument and std::runtime_error
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+const char kMagic[4] = {'C', 'R', 'H', 'Y'}; // First four bytes of every sealed message
+constexpr size_t kHeaderBytes = 12; // Magic, version, reserved bytes and capsule length
+
+// Session key that is wiped when it goes out of scope
+struct SessionKey {
+    uint8_t bytes[kHybridKeyBytes]; // Key material
+    ~SessionKey() { OPENSSL_cleanse(bytes, sizeof(bytes)); } // Wipe
+};
+
+// Cipher context that is freed when it goes out of scope
+struct CipherContext {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new(); // OpenSSL context
+    ~CipherContext() { EVP_CIPHER_CTX_free(ctx); } // Release
+};
+
+// Runs AES-256-GCM over in[0, size) into out; on encryption tag receives the tag, on decryption it is checked.
+// Returns false only when decryption fails authentication.
+bool gcm_crypt(bool encrypt, const uint8_t* key, const uint8_t* nonce, std::string_view header, std::string_view associated_data,
+               const uint8_t* in, size_t size, uint8_t* out, uint8_t* tag) { // Function to run the bulk cipher
+    CipherContext cipher; // Context for this message
+    int written = 0; // Bytes produced by one call
+    auto fail = [](const char* what) { return std::runtime_error(std::string("AES-GCM ") + what + " failed."); }; // Library errors
+    if (cipher.ctx == nullptr) throw fail("context allocation"); // Out of memory
+    if (EVP_CipherInit_ex(cipher.ctx, EVP_aes_256_gcm(), nullptr, key, nonce, encrypt ? 1 : 0) != 1) throw fail("setup"); // Key and 96-bit nonce
+    for (std::string_view aad : {header, associated_data}) { // Header and capsule first, then the caller's data
+        if (!aad.empty() && EVP_CipherUpdate(cipher.ctx, nullptr, &written, reinterpret_cast<const uint8_t*>(aad.data()), static_cast<int>(aad.size())) != 1) { // Authenticate only
+            throw fail("associated data"); // Library error
+        }
+    }
+    for (size_t done = 0; done < size;) { // EVP takes int lengths, so very large payloads go in pieces
+        int piece = static_cast<int>(std::min<size_t>(size - done, INT_MAX / 2)); // Next piece
+        if (EVP_CipherUpdate(cipher.ctx, out + done, &written, in + done, piece) != 1) throw fail("update"); // Encrypt or decrypt in place of out
+        done += static_cast<size_t>(piece); // GCM is a stream mode, so written == piece
+    }
+    if (!encrypt && EVP_CIPHER_CTX_ctrl(cipher.ctx, EVP_CTRL_GCM_SET_TAG, static_cast<int>(kHybridTagBytes), tag) != 1) throw fail("tag setup"); // Expected tag
+    if (EVP_CipherFinal_ex(cipher.ctx, out + size, &written) != 1) { // Checks the tag when decrypting
+        if (!encrypt) return false; // Authentication failed
+        throw fail("finalization"); // Library error
+    }
+    if (encrypt && EVP_CIPHER_CTX_ctrl(cipher.ctx, EVP_CTRL_GCM_GET_TAG, static_cast<int>(kHybridTagBytes), tag) != 1) throw fail("tag"); // Produced tag
+    return true; // Done
+}
+
+} // End of anonymous namespace
+
+size_t hybrid_overhead(const RingLWECrypto& crypto) { // Function to size the sealed message overhead
+    const RingLWEEngine& engine = crypto.engine(); // Parameter set
+    return kHeaderBytes + serialized_size(engine.degree(), engine.modulus(), 2) + kHybridNonceBytes + kHybridTagBytes; // Everything but the payload
+}
+
+std::string hybrid_encrypt(RingLWECrypto& crypto, std::string_view plaintext, std::string_view associated_data) { // Function to seal a message
+    RingLWEEngine& engine = crypto.engine(); // Parameter set
+    const size_t capsule_bytes = serialized_size(engine.degree(), engine.modulus(), 2); // Encapsulated key size
+    std::string sealed(hybrid_overhead(crypto) + plaintext.size(), '\0'); // Whole message, written in place
+    uint8_t* p = reinterpret_cast<uint8_t*>(&sealed[0]); // Write cursor
+
+    std::memcpy(p, kMagic, sizeof(kMagic)); // Magic
+    p[4] = kHybridVersion; // Version
+    for (int i = 0; i < 4; ++i) p[8 + i] = static_cast<uint8_t>(capsule_bytes >> (8 * i)); // Capsule length, little-endian
+
+    SessionKey key; // Fresh per message
+    Sampler& sampler = Sampler::thread_local_instance(); // Per-thread random source
+    sampler.fill_bytes(key.bytes, sizeof(key.bytes)); // Session key
+    Ciphertext capsule = engine.encrypt(std::string_view(reinterpret_cast<const char*>(key.bytes), sizeof(key.bytes))); // Encapsulate it
+    const int32_t* parts[2] = {capsule.first.data(), capsule.second.data()}; // (c1, c2)
+    serialize_polynomials_into(BlobType::ciphertext, engine.modulus(), engine.degree(), parts, 2, p + kHeaderBytes); // Pack in place
+
+    uint8_t* nonce = p + kHeaderBytes + capsule_bytes; // Nonce follows the capsule
+    sampler.fill_bytes(nonce, kHybridNonceBytes); // Random nonce; the key is never reused anyway
+    uint8_t* body = nonce + kHybridNonceBytes; // Encrypted payload
+    const std::string_view header(sealed.data(), kHeaderBytes + capsule_bytes); // Authenticated header and capsule
+    gcm_crypt(true, key.bytes, nonce, header, associated_data, reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(), body,
+              body + plaintext.size()); // Encrypt and tag
+    CRYPTO_LOG(trace) << "Sealed " << plaintext.size() << "-byte payload"; // Log the size, never the plaintext
+    return sealed; // Return the sealed message
+}
+
+std::string hybrid_decrypt(RingLWECrypto& crypto, std::string_view sealed, std::string_view associated_data) { // Function to open a message
+    RingLWEEngine& engine = crypto.engine(); // Parameter set
+    const size_t capsule_bytes = serialized_size(engine.degree(), engine.modulus(), 2); // Encapsulated key size
+    const size_t overhead = hybrid_overhead(crypto); // Everything but the payload
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(sealed.data()); // Read cursor
+    if (sealed.size() < overhead || std::memcmp(p, kMagic, sizeof(kMagic)) != 0) { // Check the magic and the minimum size
+        throw std::invalid_argument("Not a sealed message for these parameters."); // Throw invalid argument
+    }
+    if (p[4] != kHybridVersion || p[5] != 0 || p[6] != 0 || p[7] != 0) { // Check the version
+        throw std::invalid_argument("Unsupported sealed message version " + std::to_string(p[4]) + "."); // Throw invalid argument
+    }
+    const size_t stated = p[8] | (p[9] << 8) | (p[10] << 16) | (static_cast<size_t>(p[11]) << 24); // Capsule length
+    if (stated != capsule_bytes) throw std::invalid_argument("Sealed message was made for other parameters."); // Throw invalid argument
+
+    Ciphertext capsule = crypto.ciphertext_from_bytes(sealed.substr(kHeaderBytes, capsule_bytes)); // Parse the capsule
+    std::string slots(engine.max_plaintext_size(), '\0'); // Every byte slot of the capsule
+    engine.decrypt_raw(capsule, reinterpret_cast<uint8_t*>(&slots[0])); // Decapsulate
+    SessionKey key; // Recovered session key
+    std::memcpy(key.bytes, slots.data(), sizeof(key.bytes)); // First 32 slots
+    OPENSSL_cleanse(&slots[0], slots.size()); // Wipe the copy
+
+    const uint8_t* nonce = p + kHeaderBytes + capsule_bytes; // Nonce follows the capsule
+    const uint8_t* body = nonce + kHybridNonceBytes; // Encrypted payload
+    const size_t size = sealed.size() - overhead; // Payload length
+    uint8_t tag[kHybridTagBytes]; // Expected tag, copied so OpenSSL gets a writable buffer
+    std::memcpy(tag, body + size, sizeof(tag)); // Tag follows the payload
+    std::string plaintext(size, '\0'); // Decrypted payload
+    if (!gcm_crypt(false, key.bytes, nonce, sealed.substr(0, kHeaderBytes + capsule_bytes), associated_data, body, size,
+                   reinterpret_cast<uint8_t*>(&plaintext[0]), tag)) { // Decrypt and verify
+        OPENSSL_cleanse(&plaintext[0], plaintext.size()); // Never hand out unauthenticated data
+        throw std::invalid_argument("Sealed message failed authentication."); // Throw invalid argument
+    }
+    CRYPTO_LOG(trace) << "Opened " << size << "-byte payload"; // Log the size, never the plaintext
+    return plaintext; // Return the payload
+}
+
+}  // namespace lattice_crypto
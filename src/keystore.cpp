@@ -0,0 +1,180 @@
+#include "keystore.h"  // Include the header file for declarations
+#include "ring_lwe.h"  // For RingLWEEngine
+#include "ntt_plan.h"  // For checking the stored NTT-domain forms
+#include "crypto_log.h"  // Leveled asynchronous logging
+#include <cerrno>  // For errno
+#include <cstring>  // For std::memcpy and std::strerror
+#include <stdexcept>  // For std::runtime_error and std::invalid_argument
+#include <vector>  // For std::vector
+#include <fcntl.h>  // For open
+#include <sys/mman.h>  // For mmap
+#include <sys/stat.h>  // For fstat
+#include <unistd.h>  // For write, fsync, close and getpid
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+const char kMagic[4] = {'C', 'R', 'K', 'S'}; // First four bytes of every keystore
+constexpr uint32_t kByteOrderMarker = 0x01020304; // Reads back differently on a host of the other endianness
+constexpr uint32_t kHasSecret = 1; // Flag bit set when the secret key is present
+constexpr size_t kArrayAlignment = 64; // Key arrays start on cache-line and AVX-512 boundaries
+
+// Distance between consecutive key arrays
+size_t array_stride(size_t n) { // Function to size one key array
+    return (n * sizeof(int32_t) + kArrayAlignment - 1) / kArrayAlignment * kArrayAlignment; // Round up to the alignment
+}
+
+// Directory holding path, for syncing the rename
+std::string parent_directory(const std::string& path) { // Function to strip the file name
+    const size_t slash = path.find_last_of('/'); // Last separator
+    if (slash == std::string::npos) return "."; // Relative name in the working directory
+    return slash == 0 ? "/" : path.substr(0, slash); // Keep the root itself
+}
+
+// Error message for the last failed system call
+std::runtime_error system_error(const std::string& what, const std::string& path) { // Function to describe an I/O error
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno)); // Include the reason
+}
+
+} // End of anonymous namespace
+
+MappedFile::MappedFile(const std::string& path) : bytes(nullptr), length(0) { // Constructor mapping a file
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // Open for reading only
+    if (fd < 0) throw system_error("Cannot open", path); // Report the failure
+    struct stat info; // File metadata
+    if (::fstat(fd, &info) != 0) { // Read the length
+        ::close(fd); // Release the descriptor
+        throw system_error("Cannot stat", path); // Report the failure
+    }
+    length = static_cast<size_t>(info.st_size); // Whole file
+    if (length == 0) { // mmap rejects empty mappings
+        ::close(fd); // Release the descriptor
+        throw std::runtime_error("Cannot map empty file " + path); // Report the failure
+    }
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0); // Read-only pages shared with every other mapper
+    ::close(fd); // The mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED) throw system_error("Cannot map", path); // Report the failure
+    ::madvise(mapping, length, MADV_WILLNEED); // Start reading the pages in now; purely a hint
+    bytes = static_cast<const uint8_t*>(mapping); // Keep the mapping
+}
+
+MappedFile::~MappedFile() { // Destructor releasing the mapping
+    ::munmap(const_cast<uint8_t*>(bytes), length); // Unmap
+}
+
+void write_keystore(const std::string& path, const RingLWEEngine& engine, bool include_secret) { // Function to save keys
+    const size_t n = static_cast<size_t>(engine.degree()); // Ring degree
+    const size_t stride = array_stride(n); // Bytes per key array
+    std::vector<const RingKey*> keys = {&engine.public_keys().first, &engine.public_keys().second}; // Keys to write
+    if (include_secret) { // Decrypting keystore
+        if (engine.secret().empty()) throw std::logic_error("This instance has no secret key."); // Encrypt-only engine
+        keys.push_back(&engine.secret()); // Add the secret key
+    }
+
+    std::vector<uint8_t> image(kKeystoreHeaderBytes + 2 * keys.size() * stride, 0); // Whole file, zero padded
+    const uint32_t header[6] = {0, kKeystoreVersion, kByteOrderMarker, static_cast<uint32_t>(n),
+                                static_cast<uint32_t>(engine.modulus()), include_secret ? kHasSecret : 0}; // Header fields
+    std::memcpy(image.data(), header, sizeof(header)); // Header
+    std::memcpy(image.data(), kMagic, sizeof(kMagic)); // Magic over the first field
+    uint8_t* out = image.data() + kKeystoreHeaderBytes; // First key array
+    for (const RingKey* key : keys) { // Loop through each key
+        std::memcpy(out, key->data(), n * sizeof(int32_t)); // Coefficient form
+        std::memcpy(out + stride, key->ntt_data(engine.plan()), n * sizeof(int32_t)); // NTT-domain form
+        out += 2 * stride; // Next key
+    }
+
+    // Write next to the target and rename over it, so readers never map a half-written keystore
+    const std::string temporary = path + ".tmp." + std::to_string(::getpid()); // Same directory as the target
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600); // Secret keys are private to the owner
+    if (fd < 0) throw system_error("Cannot create", temporary); // Report the failure
+    for (size_t written = 0; written < image.size();) { // Loop until everything is written
+        ssize_t count = ::write(fd, image.data() + written, image.size() - written); // Write the rest
+        if (count < 0 && errno == EINTR) continue; // Retry interrupted writes
+        if (count < 0) { // Give up on real errors
+            ::close(fd); // Release the descriptor
+            ::unlink(temporary.c_str()); // Drop the partial file
+            throw system_error("Cannot write", temporary); // Report the failure
+        }
+        written += static_cast<size_t>(count); // Advance
+    }
+    if (::fsync(fd) != 0 || ::close(fd) != 0) { // Make the contents durable before they become visible
+        ::unlink(temporary.c_str()); // Drop the file
+        throw system_error("Cannot write", temporary); // Report the failure
+    }
+    if (::rename(temporary.c_str(), path.c_str()) != 0) { // Atomically replace the target
+        ::unlink(temporary.c_str()); // Drop the file
+        throw system_error("Cannot replace", path); // Report the failure
+    }
+    const std::string directory = parent_directory(path); // The rename lives in the directory entry
+    int directory_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); // Open the directory to sync it
+    if (directory_fd < 0) throw system_error("Cannot open", directory); // Report the failure
+    if (::fsync(directory_fd) != 0) { // Make the rename itself durable
+        ::close(directory_fd); // Release the descriptor
+        throw system_error("Cannot sync", directory); // Report the failure
+    }
+    ::close(directory_fd); // Release the descriptor
+    CRYPTO_LOG(info) << "Wrote keystore " << path << " for n: " << n << ", q: " << engine.modulus() <<
+        (include_secret ? "" : " (public key only)"); // Log the save
+}
+
+KeystoreKeys load_keystore(const std::string& path) { // Function to map saved keys
+    std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(path); // Map the whole file
+    const uint8_t* bytes = file->data(); // Page-aligned start of the mapping
+    if (file->size() < kKeystoreHeaderBytes || std::memcmp(bytes, kMagic, sizeof(kMagic)) != 0) { // Check the magic
+        throw std::invalid_argument("Not a keystore: " + path); // Throw invalid argument
+    }
+    uint32_t header[6]; // Header fields
+    std::memcpy(header, bytes, sizeof(header)); // Copy out of the mapping
+    if (header[1] != kKeystoreVersion || header[2] != kByteOrderMarker) { // Check version and byte order
+        throw std::invalid_argument("Unsupported keystore version or byte order: " + path); // Throw invalid argument
+    }
+
+    KeystoreKeys keys; // Result
+    keys.n = static_cast<int>(header[3]); // Ring degree
+    keys.q = static_cast<int>(header[4]); // Modulus
+    const bool has_secret = (header[5] & kHasSecret) != 0; // Secret key present
+    const size_t n = header[3]; // Ring degree
+    if (n == 0 || n > (1u << 16) || keys.q < 2 || keys.q > 65536) { // Check the shape
+        throw std::invalid_argument("Keystore has an invalid header: " + path); // Throw invalid argument
+    }
+    const size_t stride = array_stride(n); // Bytes per key array
+    const size_t arrays = has_secret ? 6 : 4; // Both forms of each key
+    if (file->size() != kKeystoreHeaderBytes + arrays * stride) { // Check the length exactly
+        throw std::invalid_argument("Keystore has the wrong length: " + path); // Throw invalid argument
+    }
+
+    std::unique_ptr<NttPlan> plan; // Plan the NTT-domain forms were made with
+    try { // The header may name parameters with no NTT
+        plan.reset(new NttPlan(static_cast<int>(n), keys.q)); // Same root every plan over (n, q) uses
+    } catch (const std::invalid_argument&) { // Unsupported parameters
+        throw std::invalid_argument("Keystore has no NTT for its parameters: " + path); // Throw invalid argument
+    }
+    const int psi = plan->root(); // Root the forms were made with
+
+    const int32_t* array[6] = {}; // Key arrays inside the mapping
+    for (size_t k = 0; k < arrays; ++k) { // Loop through each array
+        array[k] = reinterpret_cast<const int32_t*>(bytes + kKeystoreHeaderBytes + k * stride); // 64-byte aligned
+        for (size_t i = 0; i < n; ++i) { // A few KiB; much cheaper than the key generation it replaces
+            if (array[k][i] < 0 || array[k][i] >= keys.q) { // Every form is reduced into [0, q)
+                throw std::invalid_argument("Keystore coefficient out of range [0, q): " + path); // Throw invalid argument
+            }
+        }
+    }
+    std::vector<int32_t> transformed(n); // Scratch for recomputing each NTT-domain form
+    for (size_t k = 0; k < arrays; k += 2) { // Loop through each key; one transform per key at load time only
+        std::memcpy(transformed.data(), array[k], n * sizeof(int32_t)); // Coefficient form
+        plan->forward(transformed.data()); // Transform it
+        if (std::memcmp(transformed.data(), array[k + 1], n * sizeof(int32_t)) != 0) { // Both forms must be the same key
+            throw std::invalid_argument("Keystore NTT form does not match its coefficients: " + path); // Throw invalid argument
+        }
+    }
+    keys.public_keys.first = RingKey(file, array[0], array[1], n, keys.q, psi); // a and NTT(a)
+    keys.public_keys.second = RingKey(file, array[2], array[3], n, keys.q, psi); // b and NTT(b)
+    if (has_secret) keys.secret = RingKey(file, array[4], array[5], n, keys.q, psi); // s and NTT(s)
+    CRYPTO_LOG(info) << "Mapped keystore " << path << " for n: " << n << ", q: " << keys.q <<
+        (has_secret ? "" : " (public key only)"); // Log the load
+    return keys; // Return the mapped keys
+}
+
+}  // namespace lattice_crypto
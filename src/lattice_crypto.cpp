@@ -1,314 +1,328 @@
 #include "lattice_crypto.h"  // Include the header file for declarations
-#include <random>  // For random number generation
-#include <iostream>  // For input-output operations
-#include <fstream>  // For logging output to a file
-#include <openssl/rand.h>  // OpenSSL for cryptographic random number generation
-#include <iomanip>  // For std::setw and std::setfill
+#include "lattice_crypto_internal.h"  // Helpers shared with the parameter-set engines
+#include "crypto_log.h"  // Leveled asynchronous logging
+#include "keystore.h"  // Memory-mapped key files
+#include "sampler.h"  // Block-buffered random sampling
+#include "serialization.h"  // Bit-packed key and ciphertext format
+#include "thread_pool.h"  // Work-stealing pool for the batch entry points
+#include "workspace.h"  // Per-thread scratch buffers
+#include <algorithm> // For std::copy
 #include <vector> // For std::vector
-#include <cmath> // For std::log2
-#include <stdexcept> // For std::runtime_error
-
-#if __has_include(<filesystem>) // Check if filesystem is available
-  #include <filesystem> // For C++17 filesystem support
-  namespace fs = std::filesystem; // Alias for filesystem namespace
-#elif __has_include(<experimental/filesystem>) // Check if experimental filesystem is available
-  #include <experimental/filesystem> // For C++17 experimental filesystem support
-  namespace fs = std::experimental::filesystem; // Alias for experimental filesystem namespace
-#else // No filesystem support
-  #error "No filesystem support" // Error message
-#endif // End of filesystem check
-
-// Global log file variable
-std::ofstream log_file; // Log file stream
-
-void init_logging() { // Function to initialize logging
-    // Ensure log directory exists
-    try { // Try block to handle exceptions
-        if (!fs::create_directories("logs")) { // Create logs directory
-            std::cerr << "Log directory already exists or failed to create." << std::endl; // Error message
-        }
-    } catch (const fs::filesystem_error& e) { // Catch filesystem errors
-        std::cerr << "Filesystem error: " << e.what() << std::endl; // Error message
-        exit(EXIT_FAILURE);  // Exit if the log directory can't be created
-    }
+#include <stdexcept> // For std::runtime_error and std::logic_error
+#include <mutex> // For std::call_once
 
-    // Start logging to a file inside the logs directory
-    log_file.open("logs/crypto_log.txt", std::ios::out | std::ios::app);  // Open in append mode
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+// Add x into acc coefficient-wise, both in [0, q)
+void add_mod(RingElement& acc, const RingElement& x, int q) { // Function to add ring elements
+    add_mod(acc.data(), x.data(), acc.size(), q); // Same over the raw coefficients
+}
 
-    if (!log_file.is_open()) { // Check if the log file is open
-        std::cerr << "Failed to open log file." << std::endl; // Error message
-        exit(EXIT_FAILURE);  // Exit if the log file can't be opened
+void add_mod(int32_t* acc, const int32_t* x, size_t n, int q) { // Function to add coefficient arrays
+    for (size_t i = 0; i < n; ++i) { // Loop through each coefficient
+        int32_t sum = acc[i] + x[i]; // Add the coefficients
+        acc[i] = sum >= q ? sum - q : sum; // Reduce the sum
     }
+}
 
-    log_file << "Logging started." << std::endl; // Log the start of logging
-    log_file.flush();  // Flush immediately after writing
+// Centered binomial errors, reduced into [0, q)
+void sample_error(int32_t* out, size_t n, int q) { // Function to sample an error polynomial in place
+    Sampler::thread_local_instance().fill_centered_binomial(out, n, kErrorEta); // Sample centered errors
+    for (size_t i = 0; i < n; ++i) { // Loop through each coefficient
+        if (out[i] < 0) out[i] += q; // Bring into [0, q)
+    }
 }
 
-namespace lattice_crypto { // Start of lattice_crypto namespace
+// Constructor for KeyGenerator
+KeyGenerator::KeyGenerator(std::shared_ptr<const NttPlan> plan) : plan(std::move(plan)) {} // Keep the shared plan
 
-// Modular exponentiation function with base, exponent, and modulo
-int mod_exp(int base, int exp, int mod) { // Function to calculate modular exponentiation
-    log_file << "Modular exponentiation started: base=" << base << ", exp=" << exp << ", mod=" << mod << std::endl; // Log the start of modular exponentiation  
-    log_file.flush();  // Flush the log after each log entry
-    int result = 1; // Initialize result to 1
-    base %= mod;  // Always reduce base modulo
-    while (exp > 0) { // Loop until exponent is greater than 0
-        if (exp & 1) result = (1LL * result * base) % mod; // If exponent is odd, multiply result by base and take modulo
-        base = (1LL * base * base) % mod; // Square the base and take modulo
-        exp >>= 1; // Right shift the exponent
+// Return a plan for (n, q), reusing the shared one whenever it matches
+const NttPlan& KeyGenerator::plan_for(int n, int q) { // Function to look up the NTT plan
+    if (!plan || plan->size() != n || plan->modulus() != q) { // Check whether the cached plan fits
+        CRYPTO_LOG(debug) << "Building NTT plan for n: " << n << ", q: " << q; // Log the plan construction
+        plan = std::make_shared<const NttPlan>(n, q); // Build the tables once
     }
-    log_file << "Modular exponentiation result: " << result << std::endl; // Log the result of modular exponentiation
-    log_file.flush(); // Flush the log after each log entry
-    return result; // Return the result
+    return *plan; // Return the cached plan
 }
 
-// Helper function to reverse bits of a number up to 'log_n' bits
-int reverse_bits(int num, int log_n) { // Function to reverse bits of a number
-    log_file << "Reversing bits for number: " << num << ", log_n: " << log_n << std::endl; // Log the start of bit reversal
-    int reversed = 0; // Initialize reversed number to 0
-    for (int i = 0; i < log_n; ++i) { // Loop through each bit
-        if (num & (1 << i)) reversed |= 1 << (log_n - 1 - i); // Reverse the bit
-    }
-    log_file << "Reversed bits result: " << reversed << std::endl; // Log the result of bit reversal
-    return reversed; // Return the reversed number
+// Secure random {0, 1} polynomial generation
+RingElement KeyGenerator::generate_random_polynomial(int n) { // Function to generate random polynomial
+    CRYPTO_LOG(trace) << "Generating random polynomial of degree: " << n; // Log the generation
+    RingElement polynomial(n); // Zero polynomial of degree n
+    Sampler::thread_local_instance().fill_binary(polynomial.data(), polynomial.size()); // Sample the coefficients
+    return polynomial; // Return the generated polynomial
 }
 
-// Number Theoretic Transform (NTT) implementation for polynomial multiplication
-std::vector<int> ntt(const std::vector<int>& a, int n, int root, int mod) { // Function to perform Number Theoretic Transform
-    log_file << "Starting NTT for vector of size " << a.size() << " with n: " << n << ", root: " << root << ", mod: " << mod << std::endl; // Log the start of NTT
-    std::vector<int> A(n); // Initialize vector A with size n
-    int log_n = std::log2(n); // Calculate log base 2 of n
-    for (int i = 0; i < n; ++i) { // Loop through each element of A
-        A[i] = a[reverse_bits(i, log_n)]; // Reverse the bits and assign the value
-    }
-    for (int length = 2; length <= n; length <<= 1) { // Loop through each length
-        int w_length = mod_exp(root, (mod - 1) / length, mod); // Calculate w_length
-        for (int i = 0; i < n; i += length) { // Loop through each element of A
-            int w = 1; // Initialize w to 1
-            for (int j = 0; j < length / 2; ++j) { // Loop through each element of A
-                int u = A[i + j]; // Assign value to u
-                int v = (1LL * A[i + j + length / 2] * w) % mod; // Calculate v
-                A[i + j] = (u + v) % mod; // Assign value to A[i + j]
-                A[i + j + length / 2] = (u - v + mod) % mod; // Assign value to A[i + j + length / 2]
-                w = (1LL * w * w_length) % mod; // Update w
-            }
-        }
-    }
-    log_file << "NTT completed." << std::endl; // Log the completion of NTT
-    return A; // Return the transformed vector
+// Uniform polynomial generation over [0, q)
+RingElement KeyGenerator::generate_uniform_polynomial(int n, int q) { // Function to generate uniform polynomial
+    CRYPTO_LOG(trace) << "Generating uniform polynomial of degree: " << n << ", q: " << q; // Log the generation
+    RingElement polynomial(n); // Zero polynomial of degree n
+    Sampler::thread_local_instance().fill_uniform(polynomial.data(), polynomial.size(), q); // Sample the coefficients
+    return polynomial; // Return the generated polynomial
 }
 
-// Inverse NTT
-std::vector<int> intt(const std::vector<int>& a, int n, int inv_root, int mod) { // Function to perform Inverse Number Theoretic Transform
-    log_file << "Starting inverse NTT..." << std::endl; // Log the start of inverse NTT
-    std::vector<int> A = ntt(a, n, inv_root, mod); // Perform NTT with inverse root
-    int inv_n = mod_exp(n, mod - 2, mod);  // Fermat's Little Theorem
-    for (int &x : A) { // Loop through each element of A
-        x = (1LL * x * inv_n) % mod; // Calculate the inverse NTT
-    } // End of loop
-    log_file << "Inverse NTT completed." << std::endl; // Log the completion of inverse NTT
-    return A; // Return the transformed vector
+// Binomial error polynomial generation, reduced into [0, q)
+RingElement KeyGenerator::generate_error_polynomial(int n, int q) { // Function to generate error polynomial
+    CRYPTO_LOG(trace) << "Generating error polynomial of degree: " << n; // Log the generation
+    RingElement polynomial(n); // Zero polynomial of degree n
+    sample_error(polynomial.data(), polynomial.size(), q); // Sample centered errors into [0, q)
+    return polynomial; // Return the generated polynomial
+}
+
+// NTT-based polynomial multiplication
+RingElement KeyGenerator::polynomial_multiply(const RingElement& a, const RingElement& b, int q) { // Function to perform polynomial multiplication
+    CRYPTO_LOG(trace) << "Polynomial multiplication started..."; // Log the start of polynomial multiplication
+    if (a.size() != b.size()) { // Check if dimensions are compatible
+        CRYPTO_LOG(error) << "Polynomial sizes are not compatible for multiplication."; // Log the error
+        throw std::runtime_error("Polynomial sizes are not compatible for multiplication."); // Throw runtime error
+    } // End of check
+    const NttPlan& ntt_plan = plan_for(static_cast<int>(a.size()), q); // Precomputed tables for (n, q)
+
+    Workspace& workspace = Workspace::thread_local_instance(); // Scratch for b
+    Workspace::Scope scope(workspace, Workspace::Release::wipe); // b is the secret key during key generation
+    RingElement a_ntt = a; // Copy of a to transform in place; becomes the product
+    int32_t* b_ntt = workspace.take(b.size()); // Scratch copy of b
+    std::copy(b.begin(), b.end(), b_ntt); // Copy b
+    ntt_plan.forward(a_ntt.data()); // Perform NTT on a
+    ntt_plan.forward(b_ntt); // Perform NTT on b
+    ntt_plan.pointwise(a_ntt.data(), b_ntt, a_ntt.data()); // Multiply in the NTT domain
+    ntt_plan.inverse(a_ntt.data()); // Perform inverse NTT on the result
+
+    CRYPTO_LOG(trace) << "Polynomial multiplication completed."; // Log the completion of polynomial multiplication
+    return a_ntt; // Return the product
 }
 
-// Secure random matrix generation using OpenSSL's cryptographic RNG
+// Public key generation: a is uniform, b = a * s + e
+std::pair<RingElement, RingElement> KeyGenerator::generate_keys(const RingElement& secret_key, int q) { // Function to generate keys
+    CRYPTO_LOG(debug) << "Key generation started..."; // Log the start of key generation
+    const int n = static_cast<int>(secret_key.size()); // Degree of the ring
+
+    RingElement public_key_first = generate_uniform_polynomial(n, q); // Uniform ring element a
+    RingElement public_key_second = polynomial_multiply(public_key_first, secret_key, q); // a * s
+    add_mod(public_key_second, generate_error_polynomial(n, q), q); // b = a * s + e
+
+
+    CRYPTO_LOG(debug) << "Key generation completed."; // Log the completion of key generation
+
+    return {public_key_first, public_key_second}; // Return the public key pair
+}
+
+// Secure random matrix generation (Eigen compatibility shim)
 Eigen::MatrixXi KeyGenerator::generate_random_matrix(int rows, int cols) { // Function to generate random matrix
-    log_file << "Generating random matrix with dimensions: " << rows << "x" << cols << std::endl; // Log the matrix generation
+    CRYPTO_LOG(trace) << "Generating random matrix with dimensions: " << rows << "x" << cols; // Log the matrix generation
     Eigen::MatrixXi mat(rows, cols); // Initialize matrix with given dimensions
-    
-    for (int i = 0; i < rows; ++i) { // Loop through each row
-        for (int j = 0; j < cols; ++j) { // Loop through each column
-            unsigned char rand_byte; // Initialize random byte
-            if (RAND_bytes(&rand_byte, sizeof(rand_byte)) != 1) { // Generate random byte
-                log_file << "Error generating secure random bytes." << std::endl; // Log error
-                throw std::runtime_error("Error generating secure random bytes."); // Throw runtime error
-            }
-            mat(i, j) = rand_byte % 2;  // Generate either 0 or 1 for this example
-        }
-    }
-    
-    log_file << "Random matrix generated." << std::endl; // Log the completion of matrix generation
+    Sampler::thread_local_instance().fill_binary(mat.data(), static_cast<size_t>(mat.size())); // Sample every entry
     return mat; // Return the generated matrix
 }
 
-// Binomial distribution-based error generation
+// Uniform matrix generation (Eigen compatibility shim)
+Eigen::MatrixXi KeyGenerator::generate_uniform_matrix(int rows, int cols, int q) { // Function to generate uniform matrix
+    CRYPTO_LOG(trace) << "Generating uniform matrix with dimensions: " << rows << "x" << cols << ", q: " << q; // Log the matrix generation
+    Eigen::MatrixXi mat(rows, cols); // Initialize matrix with given dimensions
+    Sampler::thread_local_instance().fill_uniform(mat.data(), static_cast<size_t>(mat.size()), q); // Sample every entry
+    return mat; // Return the generated matrix
+}
+
+// Binomial error matrix generation (Eigen compatibility shim)
 Eigen::MatrixXi KeyGenerator::generate_binomial_error(int rows, int cols) { // Function to generate binomial error matrix
-    log_file << "Generating binomial error matrix with dimensions: " << rows << "x" << cols << std::endl; // Log the error matrix generation
+    CRYPTO_LOG(trace) << "Generating binomial error matrix with dimensions: " << rows << "x" << cols; // Log the error matrix generation
     Eigen::MatrixXi mat(rows, cols); // Initialize matrix with given dimensions
-    std::random_device rd; // Random device for seeding
-    std::mt19937 gen(rd()); // Mersenne Twister engine
-    std::binomial_distribution<int> binomial(10, 0.5);  // Parameters: trials=10, probability=0.5
-
-    for (int i = 0; i < rows; ++i) { // Loop through each row
-        for (int j = 0; j < cols; ++j) { // Loop through each column
-            mat(i, j) = binomial(gen) - 5;  // Center the distribution around 0
-        } // End of column loop
-    }
-    
-    log_file << "Binomial error matrix generated." << std::endl; // Log the completion of error matrix generation
+    Sampler::thread_local_instance().fill_centered_binomial(mat.data(), static_cast<size_t>(mat.size()), kErrorEta); // Sample every entry
     return mat; // Return the generated error matrix
 }
 
-// Convert matrix to hex
-std::string matrix_to_hex(const Eigen::MatrixXi& matrix) { // Function to convert matrix to hex
-    std::stringstream hex_stream; // Initialize hex stream
-    for (int i = 0; i < matrix.rows(); ++i) { // Loop through each row
-        for (int j = 0; j < matrix.cols(); ++j) { // Loop through each column
-            unsigned char value = static_cast<unsigned char>(matrix(i, j)); // Get the value
-            hex_stream << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(value); // Convert to hex and append
-        } // End of column loop
-    } // End of row loop
-    log_file << "Matrix converted to hex: " << hex_stream.str() << std::endl; // Log the hex conversion
-    return hex_stream.str(); // Return the hex string
-} // End of function
-
-// NTT-based polynomial multiplication
+// NTT-based polynomial multiplication (Eigen compatibility shim)
 Eigen::MatrixXi KeyGenerator::polynomial_multiply(const Eigen::MatrixXi& a, const Eigen::MatrixXi& b, int q) { // Function to perform polynomial multiplication
-    log_file << "Polynomial multiplication started..." << std::endl; // Log the start of polynomial multiplication
     if (a.cols() != b.rows()) { // Check if dimensions are compatible
-        log_file << "Matrix dimensions are not compatible for multiplication." << std::endl; // Log the error
+        CRYPTO_LOG(error) << "Matrix dimensions are not compatible for multiplication."; // Log the error
         throw std::runtime_error("Matrix dimensions are not compatible for multiplication."); // Throw runtime error
     } // End of check
-    int resultSize = 1; // Initialize result size to 1
-    while (resultSize < a.cols() + b.rows() - 1) { // Loop until result size is large enough
-        resultSize <<= 1;  // Ensure resultSize is a power of 2
+    RingElement a_row(a.cols()); // Row 0 of a
+    for (Eigen::Index i = 0; i < a.cols(); ++i) { // Loop through each coefficient
+        int x = a(0, i) % q; // Read and reduce
+        a_row[i] = x < 0 ? x + q : x; // Bring into [0, q)
     }
+    return to_eigen(polynomial_multiply(a_row, from_eigen(b.leftCols(1), q), q)); // Multiply by column 0 of b
+}
 
-    std::vector<int> a_values(resultSize, 0); // Initialize vector for a values
-    std::vector<int> b_values(resultSize, 0); // Initialize vector for b values
-
-    for (int i = 0; i < a.cols(); ++i) { // Loop through each column of a
-        a_values[i] = a(0, i) % q; // Assign value to a_values
-    } // End of loop
-    for (int i = 0; i < b.rows(); ++i) { // Loop through each row of b
-        b_values[i] = b(i, 0) % q; // Assign value to b_values
-    } // End of loop
-
-    int root = 3;  // Primitive root
-    int inv_root = mod_exp(root, q - 2, q);  // Modular inverse of the root
-
-    std::vector<int> a_ntt = ntt(a_values, resultSize, root, q); // Perform NTT on a
-    std::vector<int> b_ntt = ntt(b_values, resultSize, root, q); // Perform NTT on b
+// Constructors for RingKey
+RingKey::RingKey() : cache(new NttCache()) {} // Empty key
+RingKey::RingKey(RingElement coefficients) : coeffs(std::move(coefficients)), cache(new NttCache()) {} // Keep the coefficient form
+RingKey::RingKey(std::shared_ptr<const void> owner, const int32_t* coefficients, const int32_t* ntt, size_t n, int modulus, int psi) // Mapped key
+    : view(std::move(owner)), view_coeffs(coefficients), view_ntt(ntt), view_size(n), view_modulus(modulus), view_psi(psi) {} // Point at both forms
 
-    std::vector<int> result_ntt(resultSize, 0); // Initialize vector for result
-    for (int i = 0; i < resultSize; ++i) { // Loop through each element
-        result_ntt[i] = (1LL * a_ntt[i] * b_ntt[i]) % q; // Calculate the result
+// Transform the key into the NTT domain exactly once, even when several threads ask at the same time
+const int32_t* RingKey::ntt_data(const NttPlan& plan) const { // Function to get the NTT-domain key
+    if (size() != static_cast<size_t>(plan.size())) { // Check the key matches the plan
+        throw std::invalid_argument("Key size does not match the NTT plan."); // Throw invalid argument
+    }
+    if (view) { // Mapped keys carry their transformed form
+        if (view_modulus != plan.modulus() || view_psi != plan.root()) { // It only fits the transform it was made with
+            throw std::invalid_argument("Key was transformed under another NTT plan."); // Throw invalid argument
+        }
+        return view_ntt; // Return the mapped form
+    }
+    std::call_once(cache->once, [&] { // Only the first caller transforms; the rest wait for it
+        CRYPTO_LOG(debug) << "Caching NTT-domain form of key."; // Log the one-time transform
+        RingElement transformed = coeffs; // Copy the coefficients
+        plan.forward(transformed.data()); // Forward transform in place
+        cache->ntt = std::move(transformed); // Publish the cached form
+        cache->modulus = plan.modulus(); // Remember the transform it belongs to
+        cache->psi = plan.root(); // Likewise
+    });
+    if (cache->modulus != plan.modulus() || cache->psi != plan.root()) { // A later plan must be the same transform
+        throw std::invalid_argument("Key was transformed under another NTT plan."); // Throw invalid argument
     }
+    return cache->ntt.data(); // Return the cached form
+}
+
+// Constructor for RingLWECrypto
+RingLWECrypto::RingLWECrypto(int poly_degree, int modulus) // Constructor with default parameters
+    : poly_degree(poly_degree), q(modulus), lwe_engine(make_engine(poly_degree, modulus)) { // Pick the parameter set
+    CRYPTO_LOG(info) << "Initialized RingLWE Crypto with parameter set: " << lwe_engine->name(); // Log the dispatch
+}
 
-    std::vector<int> result = intt(result_ntt, resultSize, inv_root, q); // Perform inverse NTT on the result
+RingLWECrypto::RingLWECrypto(int poly_degree, int modulus, const NttKernels& kernels) // Constructor pinning the kernels
+    : poly_degree(poly_degree), q(modulus), lwe_engine(make_engine(poly_degree, modulus, kernels)) { // Pick the parameter set
+    CRYPTO_LOG(info) << "Initialized RingLWE Crypto with parameter set: " << lwe_engine->name() << " on " << kernels.name << " kernels"; // Log the dispatch
+}
 
-    Eigen::MatrixXi result_int(1, resultSize); // Initialize matrix for result
-    for (int i = 0; i < resultSize; ++i) { // Loop through each element
-        result_int(0, i) = result[i] % q; // Assign value to result_int
-        if (result_int(0, i) < 0) { // Check if value is negative
-            result_int(0, i) += q;  // Ensure values are positive
+RingLWECrypto::RingLWECrypto(std::unique_ptr<RingLWEEngine> engine) // Constructor wrapping an existing engine
+    : poly_degree(engine->degree()), q(engine->modulus()), lwe_engine(std::move(engine)) {} // Take the parameters from the engine
+
+RingLWECrypto RingLWECrypto::from_key_bytes(std::string_view public_key, std::string_view secret_key) { // Function to load serialized keys
+    BlobHeader header; // Parameters the public key was made for
+    std::vector<RingElement> pub = deserialize_polynomials(public_key, BlobType::public_key, &header); // Parse (a, b)
+    if (pub.size() != 2) throw std::invalid_argument("Public key must hold two polynomials."); // Check the count
+    RingKey secret; // Empty unless a secret key is given
+    if (!secret_key.empty()) { // Decrypting instance
+        BlobHeader secret_header; // Parameters the secret key was made for
+        std::vector<RingElement> sec = deserialize_polynomials(secret_key, BlobType::secret_key, &secret_header); // Parse s
+        if (sec.size() != 1 || secret_header.n != header.n || secret_header.q != header.q) { // Check it belongs with the public key
+            throw std::invalid_argument("Secret key does not match the public key parameters."); // Throw invalid argument
         }
+        secret = RingKey(std::move(sec[0])); // Keep the secret key
     }
-    log_file << "Polynomial multiplication completed." << std::endl; // Log the completion of polynomial multiplication
-    return result_int; // Return the result matrix
+    return RingLWECrypto(make_engine(header.n, header.q, std::move(secret), {RingKey(std::move(pub[0])), RingKey(std::move(pub[1]))})); // Dispatch on (n, q)
 }
 
-// Modify the dimensions of the public key to match poly_degree (512)
-std::pair<Eigen::MatrixXi, Eigen::MatrixXi> KeyGenerator::generate_keys(int rows, int cols, int q) { // Function to generate keys
-    log_file << "Key generation started..." << std::endl; // Log the start of key generation
-
-    // Generate secret key with dimensions rows x cols (both set to poly_degree) and random values
-    Eigen::MatrixXi secret_key = generate_random_matrix(rows, cols); // Generate random matrix for secret key
+RingLWECrypto RingLWECrypto::from_keystore(const std::string& path) { // Function to map a keystore
+    KeystoreKeys keys = load_keystore(path); // Keys pointing into the mapping
+    return RingLWECrypto(make_engine(keys.n, keys.q, std::move(keys.secret), std::move(keys.public_keys))); // Dispatch on (n, q)
+}
 
-    // Adjust public_key dimensions to match poly_degree
-    Eigen::MatrixXi public_key_first = polynomial_multiply(secret_key, generate_random_matrix(rows, cols), q); // Generate first part of public key
-    Eigen::MatrixXi public_key_second = polynomial_multiply(secret_key, generate_random_matrix(rows, cols), q); // Generate second part of public key
+void RingLWECrypto::save_keystore(const std::string& path, bool include_secret) const { // Function to write a keystore
+    write_keystore(path, *lwe_engine, include_secret); // Both forms of every key
+}
 
-    log_file << "Secret Key (hex): \n" << matrix_to_hex(secret_key) << std::endl; // Log the secret key
-    log_file << "Public Key (first part, hex): \n" << matrix_to_hex(public_key_first) << std::endl;     // Log the first part of public key
-    log_file << "Public Key (second part, hex): \n" << matrix_to_hex(public_key_second) << std::endl;  // Log the second part of public key
+std::string RingLWECrypto::public_key_bytes() const { // Function to export the public key
+    const std::pair<RingKey, RingKey>& keys = lwe_engine->public_keys(); // Public key pair
+    return serialize_polynomials(BlobType::public_key, q, poly_degree, {keys.first.data(), keys.second.data()}); // Pack (a, b)
+}
 
-    log_file << "Key generation completed." << std::endl; // Log the completion of key generation
+std::string RingLWECrypto::secret_key_bytes() const { // Function to export the secret key
+    const RingKey& secret = lwe_engine->secret(); // Secret key polynomial
+    if (secret.empty()) throw std::logic_error("This instance has no secret key."); // Encrypt-only instance
+    return serialize_polynomials(BlobType::secret_key, q, poly_degree, {secret.data()}); // Pack s
+}
 
-    return {public_key_first, public_key_second}; // Return the public key pair
+std::string RingLWECrypto::to_bytes(const Ciphertext& ciphertext) const { // Function to serialize a ciphertext
+    if (ciphertext.first.size() != static_cast<size_t>(poly_degree) || ciphertext.second.size() != static_cast<size_t>(poly_degree)) { // Check the ciphertext shape
+        throw std::invalid_argument("Ciphertext does not match the polynomial degree."); // Throw invalid argument
+    }
+    return serialize_polynomials(BlobType::ciphertext, q, poly_degree, {ciphertext.first.data(), ciphertext.second.data()}); // Pack (c1, c2)
 }
 
-// Constructor for RingLWECrypto
-RingLWECrypto::RingLWECrypto(int poly_degree, int modulus) // Constructor with default parameters
-    : poly_degree(poly_degree), q(modulus), key_gen(std::unique_ptr<KeyGenerator>(new KeyGenerator())) { // Initialize member variables
-    log_file << "Initializing RingLWE Crypto with polynomial degree: " << poly_degree << ", modulus: " << modulus << std::endl; // Log the initialization
-    secret_key = key_gen->generate_random_matrix(poly_degree, poly_degree); // Generate secret key
-    std::pair<Eigen::MatrixXi, Eigen::MatrixXi> public_key_pair = key_gen->generate_keys(poly_degree, poly_degree, q); // Generate public key pair
+Ciphertext RingLWECrypto::ciphertext_from_bytes(std::string_view data) const { // Function to parse a ciphertext
+    BlobHeader header; // Parameters the ciphertext was made for
+    std::vector<RingElement> parts = deserialize_polynomials(data, BlobType::ciphertext, &header); // Parse (c1, c2)
+    if (parts.size() != 2 || header.n != poly_degree || header.q != q) { // Check it belongs to this parameter set
+        throw std::invalid_argument("Ciphertext does not match the parameter set " + std::string(lwe_engine->name()) + "."); // Throw invalid argument
+    }
+    return {std::move(parts[0]), std::move(parts[1])}; // Return the ciphertext pair
+}
 
-    public_key.first = public_key_pair.first; // Assign first part of public key
-    public_key.second = public_key_pair.second; // Assign second part of public key
+Ciphertext RingLWECrypto::encrypt(std::string_view plaintext) { // Function to encrypt plaintext
+    Ciphertext ciphertext; // Sized by encrypt_into
+    encrypt_into(plaintext, ciphertext); // Through the pool when there is one
+    return ciphertext; // Return the ciphertext pair
+}
 
-    log_file << "Secret Key (hex): \n" << matrix_to_hex(secret_key) << std::endl; // Log the secret key
-    log_file << "Public Key (first part, hex): \n" << matrix_to_hex(public_key.first) << std::endl; // Log the first part of public key
-    log_file << "Public Key (second part, hex): \n" << matrix_to_hex(public_key.second) << std::endl; // Log the second part of public key
+std::string RingLWECrypto::decrypt(const Ciphertext& ciphertext) { // Function to decrypt ciphertext to hex
+    return lwe_engine->decrypt(ciphertext); // Forward to the engine
 }
 
-std::pair<Eigen::MatrixXi, Eigen::MatrixXi> RingLWECrypto::encrypt(const std::string& plaintext) { // Function to encrypt plaintext
-    log_file << "Starting encryption for plaintext: " << plaintext << std::endl; // Log the start of encryption
+std::string RingLWECrypto::decrypt_bytes(const Ciphertext& ciphertext) { // Function to decrypt ciphertext to bytes
+    return lwe_engine->decrypt_bytes(ciphertext); // Forward to the engine
+}
 
-    // Create the plaintext matrix with size based on poly_degree
-    Eigen::MatrixXi plaintext_matrix(1, poly_degree);  // poly_degree = 512
-    for (size_t i = 0; i < plaintext.size(); ++i) { // Loop through each character of plaintext
-        plaintext_matrix(0, i) = static_cast<int>(plaintext[i]); // Assign the ASCII value to the matrix
+void RingLWECrypto::encrypt_into(std::string_view plaintext, Ciphertext& out) { // Function to encrypt into reused storage
+    if (std::shared_ptr<RandomnessPool> current = std::atomic_load(&pool)) { // Precomputed randomness available
+        current->encrypt_into(plaintext, out); // Online phase only, when the pool has an entry
+        return; // Done
     }
+    lwe_engine->encrypt_into(plaintext, out); // Forward to the engine
+}
 
-    // Fill remaining part of the matrix with zeros if plaintext size < poly_degree
-    if (plaintext.size() < static_cast<size_t>(poly_degree)) { // Check if plaintext size is less than poly_degree
-        for (size_t i = plaintext.size(); i < static_cast<size_t>(poly_degree); ++i) { // Loop through remaining elements
-            plaintext_matrix(0, i) = 0; // Fill with zeros
-        }
-    }
+void RingLWECrypto::enable_randomness_pool(const RandomnessPoolOptions& options) { // Function to start a pool
+    disable_randomness_pool(); // Stop any pool already running first
+    std::atomic_store(&pool, std::make_shared<RandomnessPool>(*lwe_engine, options)); // Start filling
+}
 
-    // Generate the error matrix
-    Eigen::MatrixXi error_matrix = key_gen->generate_binomial_error(1, poly_degree); // Generate error matrix
+void RingLWECrypto::disable_randomness_pool() { // Function to stop the pool
+    std::atomic_store(&pool, std::shared_ptr<RandomnessPool>()); // The last encryption using it joins the refill thread and wipes the entries
+}
 
-    // Log the dimensions for debugging
-    log_file << "public_key.first dimensions: " << public_key.first.rows() << " x " << public_key.first.cols() << std::endl; // Log the dimensions of public_key.first
-    log_file << "plaintext_matrix dimensions: " << plaintext_matrix.rows() << " x " << plaintext_matrix.cols() << std::endl; // Log the dimensions of plaintext_matrix
-    log_file << "plaintext_matrix.transpose() dimensions: " << plaintext_matrix.transpose().rows() << " x " << plaintext_matrix.transpose().cols() << std::endl; // Log the dimensions of plaintext_matrix.transpose()
+std::shared_ptr<RandomnessPool> RingLWECrypto::randomness_pool() const { // Function to get the running pool
+    return std::atomic_load(&pool); // Current pool, or nullptr
+}
 
-    // Check dimensions before performing multiplication
-    if (public_key.first.cols() == plaintext_matrix.transpose().rows()) {   // Check if dimensions are compatible
-        Eigen::MatrixXi c1 = key_gen->polynomial_multiply(public_key.first, plaintext_matrix.transpose(), q).transpose(); // Perform polynomial multiplication
-        Eigen::MatrixXi c2 = plaintext_matrix + key_gen->polynomial_multiply(public_key.second, error_matrix.transpose(), q).transpose(); // Perform polynomial multiplication
+void RingLWECrypto::decrypt_into(const Ciphertext& ciphertext, std::string& out) { // Function to decrypt into reused storage
+    lwe_engine->decrypt_into(ciphertext, out); // Forward to the engine
+}
 
-        log_file << "Plaintext matrix (hex): " << matrix_to_hex(plaintext_matrix) << std::endl; // Log the plaintext matrix
-        log_file << "Ciphertext c1 (hex): " << matrix_to_hex(c1) << std::endl; // Log the first part of ciphertext
-        log_file << "Ciphertext c2 (hex): " << matrix_to_hex(c2) << std::endl; // Log the second part of ciphertext
+// Decryption of Eigen row vectors (compatibility shim)
+std::string RingLWECrypto::decrypt(const std::pair<Eigen::MatrixXi, Eigen::MatrixXi>& ciphertext) { // Function to decrypt Eigen ciphertext
+    return decrypt(Ciphertext(from_eigen(ciphertext.first, q), from_eigen(ciphertext.second, q))); // Convert and decrypt
+}
 
-        return {c1, c2}; // Return the ciphertext pair
-    } else { // Dimensions are not compatible
-        log_file << "Error: Matrix dimensions are not compatible for multiplication." << std::endl; // Log the error
-        log_file << "public_key.first.cols(): " << public_key.first.cols() << ", plaintext_matrix.transpose().rows(): " << plaintext_matrix.transpose().rows() << std::endl;  // Log the dimensions
-        throw std::runtime_error("Matrix dimensions are not compatible for multiplication."); // Throw runtime error
-    }
+std::vector<Ciphertext> RingLWECrypto::encrypt_batch(const std::vector<std::string>& plaintexts) { // Function to encrypt many plaintexts
+    return encrypt_batch(std::vector<std::string_view>(plaintexts.begin(), plaintexts.end())); // View the strings without copying them
 }
-// Decryption
-std::string RingLWECrypto::decrypt(const std::pair<Eigen::MatrixXi, Eigen::MatrixXi>& ciphertext) { // Function to decrypt ciphertext
-    log_file << "Starting decryption..." << std::endl; // Log the start of decryption
-    Eigen::MatrixXi c1 = ciphertext.first; // Assign first part of ciphertext
-    Eigen::MatrixXi c2 = ciphertext.second; // Assign second part of ciphertext
-
-    Eigen::MatrixXi m = key_gen->polynomial_multiply(c1, secret_key, q); // Perform polynomial multiplication
-    m = c2 - m; // Subtract the result from c2
-
-    std::stringstream hex_stream; // Initialize hex stream
-    bool found_padding = false; // Initialize padding flag
-    for (int i = 0; i < m.cols(); ++i) { // Loop through each column
-        unsigned char decrypted_byte = static_cast<unsigned char>(m(0, i)); // Get the decrypted byte
-        if (decrypted_byte == 0 || decrypted_byte == 0xff) { // Check for padding
-            found_padding = true; // Set padding flag
-            break; // Exit the loop
-        }
-        hex_stream << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(decrypted_byte); // Convert to hex and append
-    }
 
-    if (found_padding) { // Check if padding was found
-        log_file << "Padding found and stripped from the decrypted message." << std::endl; // Log the padding
-    }
+std::vector<Ciphertext> RingLWECrypto::encrypt_batch(const std::vector<std::string_view>& plaintexts) { // Function to encrypt many plaintexts
+    CRYPTO_LOG(debug) << "Encrypting batch of " << plaintexts.size() << " messages."; // Log the batch
+    std::vector<Ciphertext> ciphertexts(plaintexts.size()); // One slot per message, written by exactly one worker
+    ThreadPool::shared().parallel_for(plaintexts.size(), [&](size_t i) { // Spread the messages over the cores
+        lwe_engine->encrypt_into(plaintexts[i], ciphertexts[i]); // Encrypt one message
+    });
+    return ciphertexts; // Return the ciphertexts in input order
+}
 
-    log_file << "Decrypted hex: " << hex_stream.str() << std::endl; // Log the decrypted hex
+std::vector<std::string> RingLWECrypto::decrypt_batch(const std::vector<Ciphertext>& ciphertexts) { // Function to decrypt many ciphertexts
+    CRYPTO_LOG(debug) << "Decrypting batch of " << ciphertexts.size() << " messages."; // Log the batch
+    std::vector<std::string> plaintexts(ciphertexts.size()); // One slot per message, written by exactly one worker
+    ThreadPool::shared().parallel_for(ciphertexts.size(), [&](size_t i) { // Spread the messages over the cores
+        plaintexts[i] = lwe_engine->decrypt(ciphertexts[i]); // Decrypt one message
+    });
+    return plaintexts; // Return the plaintexts in input order
+}
+
+std::vector<std::string> RingLWECrypto::decrypt_batch_bytes(const std::vector<Ciphertext>& ciphertexts) { // Function to decrypt many ciphertexts to bytes
+    CRYPTO_LOG(debug) << "Decrypting batch of " << ciphertexts.size() << " messages to bytes."; // Log the batch
+    std::vector<std::string> plaintexts(ciphertexts.size()); // One slot per message, written by exactly one worker
+    ThreadPool::shared().parallel_for(ciphertexts.size(), [&](size_t i) { // Spread the messages over the cores
+        lwe_engine->decrypt_into(ciphertexts[i], plaintexts[i]); // Decrypt one message
+    });
+    return plaintexts; // Return the plaintexts in input order
+}
+
+size_t RingLWECrypto::max_plaintext_size() const { // Function to report the plaintext capacity
+    return lwe_engine->max_plaintext_size(); // Forward to the engine
+}
 
-    return hex_stream.str(); // Return the decrypted hex string
+const NttPlan& RingLWECrypto::plan() const { // Function to expose the transform plan
+    return lwe_engine->plan(); // Plan over the compile-time tables
 }
 
 }  // namespace lattice_crypto
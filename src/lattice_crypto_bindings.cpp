@@ -1,15 +1,295 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>  // For NumPy views over ring elements
+#include <pybind11/stl.h>  // For std::pair <-> tuple and std::vector <-> list conversions
+#include <algorithm>  // For std::copy
+#include <string_view>  // For borrowed plaintext bytes
+#include "crypto_log.h"   // Logging controls
+#include "hybrid.h"   // Lattice key encapsulation with AES-256-GCM payloads
 #include "lattice_crypto.h"   // Include the header file
+#include "metrics.h"   // Counters and latency histograms
+#include "stream.h"   // Streaming encryption of arbitrary-length payloads
 
 namespace py = pybind11;
 
 // Use the lattice_crypto namespace to avoid prefixing the class everywhere
 using namespace lattice_crypto;
 
+namespace {
+
+// Views the bytes of a buffer-protocol object (bytes, bytearray, memoryview, NumPy array) in place
+std::string_view bytes_view(const py::buffer_info& info) {
+    py::ssize_t expected = info.itemsize;
+    for (py::ssize_t i = info.ndim - 1; i >= 0; --i) {
+        if (info.shape[i] > 1 && info.strides[i] != expected) throw py::value_error("Plaintext buffer must be C-contiguous");
+        expected *= info.shape[i];
+    }
+    return {static_cast<const char*>(info.ptr), static_cast<size_t>(info.size * info.itemsize)};
+}
+
+// Copies coefficients from any integer array-like into a ring element
+RingElement ring_element_from(py::array_t<int32_t, py::array::c_style | py::array::forcecast> values) {
+    if (values.ndim() != 1) throw py::value_error("Ring element coefficients must be one-dimensional");
+    RingElement element(static_cast<size_t>(values.shape(0)));
+    std::copy(values.data(), values.data() + values.shape(0), element.data());
+    return element;
+}
+
+}  // namespace
+
 PYBIND11_MODULE(lattice_crypto, m) {
-    // Binding the RingLWECrypto class to Python
+    // Binding the RingElement class to Python; it exposes its coefficients through the buffer protocol,
+    // so numpy.asarray(element) and memoryview(element) read the C++ storage without copying
+    py::class_<RingElement>(m, "RingElement", py::buffer_protocol())
+        .def(py::init<std::size_t>())  // Zero polynomial of the given degree
+        .def(py::init(&ring_element_from))  // Copy of a NumPy array or integer sequence
+        .def_buffer([](RingElement& self) {  // int32 coefficients, one dimension
+            return py::buffer_info(self.data(), sizeof(int32_t), py::format_descriptor<int32_t>::format(), 1,
+                                   {static_cast<py::ssize_t>(self.size())}, {static_cast<py::ssize_t>(sizeof(int32_t))});
+        })
+        .def("numpy", [](py::object self) {  // NumPy view over the coefficients; keeps the element alive
+            RingElement& element = self.cast<RingElement&>();
+            return py::array_t<int32_t>({static_cast<py::ssize_t>(element.size())}, {static_cast<py::ssize_t>(sizeof(int32_t))},
+                                        element.data(), self);
+        })
+        .def("__len__", &RingElement::size)  // Number of coefficients
+        .def("__getitem__", [](const RingElement& self, std::size_t i) {  // Coefficient access
+            if (i >= self.size()) throw py::index_error();
+            return self[i];
+        })
+        .def("to_list", [](const RingElement& self) {  // Copy the coefficients into a list
+            return std::vector<int32_t>(self.begin(), self.end());
+        })
+        .def("__eq__", &RingElement::operator==);
+    py::implicitly_convertible<py::array, RingElement>();  // Ciphertexts may be passed as NumPy arrays
+    py::implicitly_convertible<py::list, RingElement>();  // or as lists of integers
+    py::implicitly_convertible<py::tuple, RingElement>();  // or as tuples of integers
+
+    // Binding the RingLWECrypto class to Python. Every entry point releases the GIL while the C++ code runs,
+    // so Python threads sharing one instance encrypt and decrypt in parallel. Streams below are the exception.
     py::class_<RingLWECrypto>(m, "RingLWECrypto")
-        .def(py::init<int, int>())  // Constructor binding
-        .def("encrypt", &RingLWECrypto::encrypt)  // Binding the encrypt method
-        .def("decrypt", &RingLWECrypto::decrypt); // Binding the decrypt method
+        .def(py::init<int, int>(), py::arg("poly_degree") = 512, py::arg("modulus") = 12289)  // Constructor binding
+        .def_static("from_keys", [](py::buffer public_key, py::object secret_key) {  // Instance over exported keys; encrypt-only without secret_key
+            py::buffer_info public_info = public_key.request();
+            py::buffer_info secret_info;
+            std::string_view secret_view;
+            if (!secret_key.is_none()) {
+                secret_info = secret_key.cast<py::buffer>().request();
+                secret_view = bytes_view(secret_info);
+            }
+            std::string_view public_view = bytes_view(public_info);
+            py::gil_scoped_release release;
+            return RingLWECrypto::from_key_bytes(public_view, secret_view);
+        }, py::arg("public_key"), py::arg("secret_key") = py::none())
+        .def_static("from_keystore", &RingLWECrypto::from_keystore,  // Instance over a memory-mapped keystore
+                    py::arg("path"), py::call_guard<py::gil_scoped_release>())
+        .def("save_keystore", &RingLWECrypto::save_keystore,  // Write the keys for from_keystore
+             py::arg("path"), py::arg("include_secret") = true, py::call_guard<py::gil_scoped_release>())
+        .def("public_key_bytes", [](const RingLWECrypto& self) {  // Public key (a, b), bit-packed
+            return py::bytes(self.public_key_bytes());
+        })
+        .def("secret_key_bytes", [](const RingLWECrypto& self) {  // Secret key s, bit-packed
+            return py::bytes(self.secret_key_bytes());
+        })
+        .def("to_bytes", [](const RingLWECrypto& self, const Ciphertext& ciphertext) {  // Ciphertext, bit-packed
+            std::string data;
+            {
+                py::gil_scoped_release release;
+                data = self.to_bytes(ciphertext);
+            }
+            return py::bytes(data);
+        }, py::arg("ciphertext"))
+        .def("from_bytes", [](const RingLWECrypto& self, py::buffer data) {  // Ciphertext from to_bytes output, read in place
+            py::buffer_info info = data.request();
+            std::string_view view = bytes_view(info);
+            py::gil_scoped_release release;
+            return self.ciphertext_from_bytes(view);
+        }, py::arg("data"))
+        .def("enable_randomness_pool", [](RingLWECrypto& self, size_t depth, size_t refill_below, bool background) {  // Precompute encryption randomness
+            RandomnessPoolOptions options;
+            options.depth = depth;
+            options.refill_below = refill_below;
+            options.background = background;
+            self.enable_randomness_pool(options);
+        }, py::arg("depth") = 64, py::arg("refill_below") = 32, py::arg("background") = true,
+           py::call_guard<py::gil_scoped_release>())
+        .def("disable_randomness_pool", &RingLWECrypto::disable_randomness_pool,  // Stop and wipe the pool
+             py::call_guard<py::gil_scoped_release>())
+        .def("refill_randomness_pool", [](RingLWECrypto& self) -> size_t {  // Fill the pool on this thread; returns entries added
+            std::shared_ptr<RandomnessPool> pool = self.randomness_pool();
+            return pool ? pool->refill() : 0;
+        }, py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("randomness_pool_ready", [](const RingLWECrypto& self) -> py::object {  // Entries ready, or None
+            std::shared_ptr<RandomnessPool> pool = self.randomness_pool();
+            if (!pool) return py::none();
+            return py::int_(pool->ready());
+        })
+        .def("encrypt", [](RingLWECrypto& self, py::buffer plaintext) {  // bytes-like plaintext, read in place
+            py::buffer_info info = plaintext.request();
+            std::string_view view = bytes_view(info);
+            py::gil_scoped_release release;
+            return self.encrypt(view);
+        }, py::arg("plaintext"))
+        .def("encrypt", [](RingLWECrypto& self, const std::string& plaintext) {  // str plaintext, encoded as UTF-8
+            py::gil_scoped_release release;
+            return self.encrypt(plaintext);
+        }, py::arg("plaintext"))
+        .def("decrypt", py::overload_cast<const Ciphertext&>(&RingLWECrypto::decrypt),  // Plaintext as hex
+             py::arg("ciphertext"), py::call_guard<py::gil_scoped_release>())
+        .def("decrypt_bytes", [](RingLWECrypto& self, const Ciphertext& ciphertext) {  // Plaintext as bytes
+            std::string plaintext;
+            {
+                py::gil_scoped_release release;
+                plaintext = self.decrypt_bytes(ciphertext);
+            }
+            return py::bytes(plaintext);
+        }, py::arg("ciphertext"))
+        .def("encrypt_batch", [](RingLWECrypto& self, const py::list& plaintexts) {  // List of bytes-like or str, on the thread pool
+            std::vector<py::buffer_info> buffers;  // Keeps bytes-like inputs pinned while the GIL is released
+            std::vector<std::string> encoded;  // UTF-8 copies of str inputs
+            buffers.reserve(plaintexts.size());
+            encoded.reserve(plaintexts.size());
+            std::vector<std::string_view> views;
+            views.reserve(plaintexts.size());
+            for (const py::handle& item : plaintexts) {
+                if (py::isinstance<py::buffer>(item)) {
+                    buffers.push_back(py::reinterpret_borrow<py::buffer>(item).request());
+                    views.push_back(bytes_view(buffers.back()));
+                } else {
+                    encoded.push_back(item.cast<std::string>());
+                    views.push_back(encoded.back());
+                }
+            }
+            py::gil_scoped_release release;
+            return self.encrypt_batch(views);
+        }, py::arg("plaintexts"))
+        .def("decrypt_batch", &RingLWECrypto::decrypt_batch,  // List of ciphertexts to hex, on the thread pool
+             py::arg("ciphertexts"), py::call_guard<py::gil_scoped_release>())
+        .def("decrypt_batch_bytes", [](RingLWECrypto& self, const std::vector<Ciphertext>& ciphertexts) {  // List of ciphertexts to bytes
+            std::vector<std::string> plaintexts;
+            {
+                py::gil_scoped_release release;
+                plaintexts = self.decrypt_batch_bytes(ciphertexts);
+            }
+            py::list result;
+            for (const std::string& plaintext : plaintexts) result.append(py::bytes(plaintext));
+            return result;
+        }, py::arg("ciphertexts"))
+        .def("hybrid_encrypt", [](RingLWECrypto& self, py::buffer plaintext, py::buffer associated_data) {  // Payload of any size, AES-256-GCM under a lattice-encapsulated key
+            py::buffer_info info = plaintext.request(), aad_info = associated_data.request();
+            std::string_view view = bytes_view(info), aad = bytes_view(aad_info);
+            std::string sealed;
+            {
+                py::gil_scoped_release release;
+                sealed = hybrid_encrypt(self, view, aad);
+            }
+            return py::bytes(sealed);
+        }, py::arg("plaintext"), py::arg("associated_data") = py::bytes())
+        .def("hybrid_decrypt", [](RingLWECrypto& self, py::buffer sealed, py::buffer associated_data) {  // Raises ValueError when authentication fails
+            py::buffer_info info = sealed.request(), aad_info = associated_data.request();
+            std::string_view view = bytes_view(info), aad = bytes_view(aad_info);
+            std::string plaintext;
+            {
+                py::gil_scoped_release release;
+                plaintext = hybrid_decrypt(self, view, aad);
+            }
+            return py::bytes(plaintext);
+        }, py::arg("sealed"), py::arg("associated_data") = py::bytes())
+        .def("max_plaintext_size", &RingLWECrypto::max_plaintext_size);  // Plaintext capacity in bytes
+
+    // Streaming encryption of payloads of any length and content; each update returns the bytes completed so far.
+    // A stream is not thread-safe, so its methods keep the GIL and two Python threads can never run one stream at
+    // once; the blocks of each update are still spread over the shared thread pool.
+    py::class_<EncryptStream>(m, "EncryptStream")
+        .def(py::init<RingLWECrypto&>(), py::arg("crypto"), py::keep_alive<1, 2>())  // Keeps crypto alive while the stream is used
+        .def("update", [](EncryptStream& self, py::buffer plaintext) {  // Plaintext chunk in, ciphertext bytes out
+            py::buffer_info info = plaintext.request();
+            std::string_view view = bytes_view(info);
+            std::string out;
+            self.update(view, out);
+            return py::bytes(out);
+        }, py::arg("plaintext"))
+        .def("finalize", [](EncryptStream& self) {  // Final block
+            std::string out;
+            self.finalize(out);
+            return py::bytes(out);
+        })
+        .def_property_readonly("block_size", &EncryptStream::block_size);  // Ciphertext bytes per block
+    py::class_<DecryptStream>(m, "DecryptStream")
+        .def(py::init<RingLWECrypto&>(), py::arg("crypto"), py::keep_alive<1, 2>())  // Keeps crypto alive while the stream is used
+        .def("update", [](DecryptStream& self, py::buffer ciphertext) {  // Ciphertext chunk in, plaintext bytes out
+            py::buffer_info info = ciphertext.request();
+            std::string_view view = bytes_view(info);
+            std::string out;
+            self.update(view, out);
+            return py::bytes(out);
+        }, py::arg("ciphertext"))
+        .def("finalize", [](DecryptStream& self) {  // Rest of the plaintext; raises ValueError on a truncated stream
+            std::string out;
+            self.finalize(out);
+            return py::bytes(out);
+        })
+        .def_property_readonly("block_size", &DecryptStream::block_size);  // Ciphertext bytes per block
+
+    // Logging controls: records go to a background writer, and nothing is logged until a log is opened
+    py::enum_<LogLevel>(m, "LogLevel")
+        .value("trace", LogLevel::trace)
+        .value("debug", LogLevel::debug)
+        .value("info", LogLevel::info)
+        .value("warn", LogLevel::warn)
+        .value("error", LogLevel::error)
+        .value("off", LogLevel::off);
+    m.def("set_log_level", &set_log_level, py::arg("level"));  // Lowest level recorded from now on
+    m.def("set_log_level", [](const std::string& name) {  // Same, by name
+        static const std::pair<const char*, LogLevel> names[] = {
+            {"trace", LogLevel::trace}, {"debug", LogLevel::debug}, {"info", LogLevel::info},
+            {"warn", LogLevel::warn}, {"error", LogLevel::error}, {"off", LogLevel::off}};
+        for (const auto& entry : names) {
+            if (name == entry.first) return set_log_level(entry.second);
+        }
+        throw py::value_error("Unknown log level: " + name);
+    }, py::arg("level"));
+    m.def("log_level", &log_level);  // Current runtime level
+    m.def("open_log", &open_log, py::arg("path"));  // Append to the given file
+    m.def("init_logging", &init_logging);  // Append to logs/crypto_log.txt
+    m.def("flush_log", &flush_log, py::call_guard<py::gil_scoped_release>());  // Wait until queued records are written
+    m.def("close_log", &close_log, py::call_guard<py::gil_scoped_release>());  // Drain and close the log
+
+    // Metrics: per-thread counters and latency histograms summed on demand
+    m.def("metrics_enabled", &metrics_enabled);  // False when the module was built with LATTICE_CRYPTO_METRICS=0
+    m.def("metrics_snapshot", []() {  // {"counters": {name: value}, "histograms": {name: {...}}}, latencies in nanoseconds
+        MetricsSnapshot snapshot;
+        {
+            py::gil_scoped_release release;
+            snapshot = metrics_snapshot();
+        }
+        py::dict counters;
+        for (size_t c = 0; c < kCounterCount; ++c) counters[counter_name(static_cast<Counter>(c))] = snapshot.counters[c];
+        py::dict histograms;
+        for (size_t h = 0; h < kHistogramCount; ++h) {
+            const HistogramSnapshot& histogram = snapshot.histograms[h];
+            py::list buckets;  // (lower_ns, upper_ns, count) of every non-empty bucket
+            for (size_t b = 0; b < histogram.buckets.size(); ++b) {
+                if (histogram.buckets[b] != 0) {
+                    buckets.append(py::make_tuple(histogram_bucket_lower(b), histogram_bucket_upper(b), histogram.buckets[b]));
+                }
+            }
+            py::dict entry;
+            entry["count"] = histogram.count;
+            entry["sum_ns"] = histogram.sum_ns;
+            entry["max_ns"] = histogram.max_ns;
+            entry["mean_ns"] = histogram.mean_ns();
+            entry["p50_ns"] = histogram.quantile_ns(0.50);
+            entry["p90_ns"] = histogram.quantile_ns(0.90);
+            entry["p99_ns"] = histogram.quantile_ns(0.99);
+            entry["p999_ns"] = histogram.quantile_ns(0.999);
+            entry["buckets"] = buckets;
+            histograms[histogram_name(static_cast<Histogram>(h))] = entry;
+        }
+        py::dict result;
+        result["counters"] = counters;
+        result["histograms"] = histograms;
+        return result;
+    });
+    m.def("reset_metrics", &reset_metrics);  // Start every metric from zero
+    m.def("metrics_prometheus", &metrics_prometheus, py::call_guard<py::gil_scoped_release>());  // Prometheus text format
 }
@@ -0,0 +1,24 @@
+#ifndef LATTICE_CRYPTO_INTERNAL_H
+#define LATTICE_CRYPTO_INTERNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "polynomial.h"
+
+namespace lattice_crypto {
+
+// Centered binomial parameter of the error distribution: values in [-5, 5], same as binomial(10, 0.5) - 5
+constexpr int kErrorEta = 5;
+
+// Adds x into acc coefficient-wise, both in [0, q)
+void add_mod(RingElement& acc, const RingElement& x, int q);
+
+// Adds n coefficients of x into acc, both in [0, q)
+void add_mod(int32_t* acc, const int32_t* x, size_t n, int q);
+
+// Fills out with n centered binomial errors drawn from this thread's Sampler, reduced into [0, q)
+void sample_error(int32_t* out, size_t n, int q);
+
+}  // namespace lattice_crypto
+
+#endif  // LATTICE_CRYPTO_INTERNAL_H
@@ -0,0 +1,215 @@
+#include "metrics.h"  // Include the header file for declarations
+#include <cstdio>  // For snprintf
+#include <memory>  // For std::unique_ptr
+#include <mutex>  // For std::mutex
+#include <vector>  // For the shard list
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+const char* const kCounterNames[kCounterCount] = { // Names, in Counter order
+    "bytes_encrypted", "bytes_decrypted", "sampled_coefficients", "allocations", "allocated_bytes",
+    "pool_hits", "pool_misses", "pool_precomputed"};
+
+const char* const kCounterHelp[kCounterCount] = { // Prometheus help, in Counter order
+    "Plaintext bytes passed to encrypt.", "Plaintext byte slots recovered by decrypt.",
+    "Coefficients drawn by the samplers.", "Ring element storage allocations.", "Bytes of ring element storage allocated.",
+    "Encryptions served from a randomness pool.", "Encryptions that found their randomness pool empty.",
+    "Encryption randomness entries precomputed."};
+
+const char* const kHistogramNames[kHistogramCount] = { // Names, in Histogram order
+    "keygen", "encrypt", "decrypt", "ntt", "sampling"};
+
+const char* const kHistogramHelp[kHistogramCount] = { // Prometheus help, in Histogram order
+    "Latency of key pair generation.", "Latency of one encryption.", "Latency of one decryption.",
+    "Latency of one forward or inverse transform in the engine.", "Latency of one sampler fill."};
+
+constexpr int kPrometheusFirstExponent = 8; // Smallest Prometheus bound: 2^8 ns = 256 ns
+constexpr int kPrometheusLastExponent = 34; // Largest Prometheus bound: 2^34 ns, about 17 s
+
+// Plain totals, used for the exited threads and the reset baseline
+struct Totals { // Same layout as a shard, without atomics
+    uint64_t counters[kCounterCount] = {}; // Counter values
+    uint64_t buckets[kHistogramCount][kHistogramBuckets] = {}; // Events per bucket
+    uint64_t sums[kHistogramCount] = {}; // Total nanoseconds
+    uint64_t maxima[kHistogramCount] = {}; // Longest events
+
+    // Adds one live shard
+    void add(const detail::MetricShard& shard) { // Function to fold in a shard
+        for (size_t c = 0; c < kCounterCount; ++c) counters[c] += shard.counters[c].load(std::memory_order_relaxed); // Counters
+        for (size_t h = 0; h < kHistogramCount; ++h) { // Loop through each histogram
+            const detail::HistogramShard& histogram = shard.histograms[h]; // Histogram of the shard
+            for (size_t b = 0; b < kHistogramBuckets; ++b) buckets[h][b] += histogram.buckets[b].load(std::memory_order_relaxed); // Buckets
+            sums[h] += histogram.sum.load(std::memory_order_relaxed); // Sum
+            uint64_t max = histogram.max.load(std::memory_order_relaxed); // Longest event
+            if (max > maxima[h]) maxima[h] = max; // Keep the longest
+        }
+    }
+};
+
+// Every live shard plus the totals of exited threads
+class Registry { // Process-wide metric state
+public:
+    std::mutex mutex; // Guards everything below
+    std::vector<detail::MetricShard*> shards; // Shards of running threads
+    Totals retired; // Totals of threads that have exited
+    Totals baseline; // Totals at the last reset_metrics
+
+    // Current totals of every thread; the caller holds mutex
+    std::unique_ptr<Totals> collect() { // Function to sum the shards
+        std::unique_ptr<Totals> totals(new Totals(retired)); // Exited threads first
+        for (const detail::MetricShard* shard : shards) totals->add(*shard); // Then every live thread
+        return totals; // Return the totals
+    }
+};
+
+// The registry is never destroyed, so threads exiting during static destruction can still fold their shards in
+Registry& registry() { // Function to get the registry
+    static Registry* instance = new Registry(); // Created on first use
+    return *instance; // Return the registry
+}
+
+// Owns one thread's shard for the life of the thread
+struct ShardHandle { // Registered on construction, folded in on destruction
+    detail::MetricShard* shard; // Shard of the thread
+
+    ShardHandle() : shard(new detail::MetricShard()) { // Constructor registering a zeroed shard
+        Registry& metrics = registry(); // Registry
+        std::lock_guard<std::mutex> lock(metrics.mutex); // Snapshots must not see a half-added list
+        metrics.shards.push_back(shard); // Register
+    }
+
+    ~ShardHandle() { // Destructor keeping the thread's totals after it exits
+        Registry& metrics = registry(); // Registry
+        std::lock_guard<std::mutex> lock(metrics.mutex); // Serialize with snapshots
+        metrics.retired.add(*shard); // Keep the totals
+        for (size_t i = 0; i < metrics.shards.size(); ++i) { // Find the shard
+            if (metrics.shards[i] == shard) { // This thread's shard
+                metrics.shards[i] = metrics.shards.back(); // Swap with the last one
+                metrics.shards.pop_back(); // And drop it
+                break; // Done
+            }
+        }
+        delete shard; // Free it
+    }
+};
+
+// Appends one printf-formatted line
+template <class... Args>
+void append_line(std::string& out, const char* format, Args... args) { // Function to format a line
+    char line[256]; // Every line written here is short
+    int length = std::snprintf(line, sizeof(line), format, args...); // Format
+    if (length > 0) out.append(line, static_cast<size_t>(length) < sizeof(line) ? static_cast<size_t>(length) : sizeof(line) - 1); // Append
+}
+
+} // End of anonymous namespace
+
+detail::MetricShard& detail::local_shard() { // Function to get this thread's shard
+    thread_local ShardHandle handle; // Registered on first use
+    return *handle.shard; // Return the shard
+}
+
+uint64_t histogram_bucket_lower(size_t bucket) { // Function to get a bucket's lower bound
+    if (bucket < kHistogramSubBuckets) return bucket; // One value per bucket below 16 ns
+    const int exponent = static_cast<int>(bucket / kHistogramSubBuckets) + kHistogramSubBucketBits - 1; // Power of two
+    const uint64_t sub = bucket % kHistogramSubBuckets; // Position within it
+    return (kHistogramSubBuckets + sub) << (exponent - kHistogramSubBucketBits); // Lower bound
+}
+
+uint64_t histogram_bucket_upper(size_t bucket) { // Function to get a bucket's upper bound
+    if (bucket < kHistogramSubBuckets) return bucket + 1; // One value per bucket below 16 ns
+    const int exponent = static_cast<int>(bucket / kHistogramSubBuckets) + kHistogramSubBucketBits - 1; // Power of two
+    return histogram_bucket_lower(bucket) + (uint64_t(1) << (exponent - kHistogramSubBucketBits)); // Lower bound plus the width
+}
+
+double HistogramSnapshot::mean_ns() const { // Function to get the mean
+    return count == 0 ? 0.0 : static_cast<double>(sum_ns) / static_cast<double>(count); // Sum over count
+}
+
+uint64_t HistogramSnapshot::quantile_ns(double quantile) const { // Function to get a quantile
+    if (count == 0) return 0; // No events
+    if (quantile < 0.0) quantile = 0.0; // Clamp below
+    if (quantile > 1.0) quantile = 1.0; // Clamp above
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(count)); // Events at or below the quantile
+    if (rank == 0) rank = 1; // At least the first event
+    uint64_t seen = 0; // Events in the buckets so far
+    for (size_t b = 0; b < buckets.size(); ++b) { // Walk up the buckets
+        seen += buckets[b]; // Events in this bucket
+        if (seen >= rank) return histogram_bucket_upper(b); // The quantile falls in this bucket
+    }
+    return histogram_bucket_upper(buckets.size() - 1); // Unreachable with consistent counts
+}
+
+bool metrics_enabled() { // Function to report the build setting
+    return LATTICE_CRYPTO_METRICS != 0; // Compiled in or out
+}
+
+const char* counter_name(Counter counter) { // Function to name a counter
+    return kCounterNames[static_cast<size_t>(counter)]; // Look up the name
+}
+
+const char* histogram_name(Histogram histogram) { // Function to name a histogram
+    return kHistogramNames[static_cast<size_t>(histogram)]; // Look up the name
+}
+
+MetricsSnapshot metrics_snapshot() { // Function to sum every thread's metrics
+    Registry& metrics = registry(); // Registry
+    std::unique_ptr<Totals> totals; // Current totals
+    {
+        std::lock_guard<std::mutex> lock(metrics.mutex); // Threads may not come or go meanwhile
+        totals = metrics.collect(); // Sum the shards
+        for (size_t c = 0; c < kCounterCount; ++c) totals->counters[c] -= metrics.baseline.counters[c]; // Since the last reset
+        for (size_t h = 0; h < kHistogramCount; ++h) { // Loop through each histogram
+            for (size_t b = 0; b < kHistogramBuckets; ++b) totals->buckets[h][b] -= metrics.baseline.buckets[h][b]; // Since the last reset
+            totals->sums[h] -= metrics.baseline.sums[h]; // Since the last reset
+        }
+    }
+
+    MetricsSnapshot snapshot; // Result
+    for (size_t c = 0; c < kCounterCount; ++c) snapshot.counters[c] = totals->counters[c]; // Counters
+    for (size_t h = 0; h < kHistogramCount; ++h) { // Loop through each histogram
+        HistogramSnapshot& histogram = snapshot.histograms[h]; // Histogram to fill
+        histogram.buckets.assign(totals->buckets[h], totals->buckets[h] + kHistogramBuckets); // Buckets
+        for (uint64_t events : histogram.buckets) histogram.count += events; // Events
+        histogram.sum_ns = totals->sums[h]; // Total time
+        histogram.max_ns = totals->maxima[h]; // Longest event
+    }
+    return snapshot; // Return the snapshot
+}
+
+void reset_metrics() { // Function to start the metrics from zero
+    Registry& metrics = registry(); // Registry
+    std::lock_guard<std::mutex> lock(metrics.mutex); // Serialize with snapshots
+    metrics.baseline = *metrics.collect(); // Later snapshots subtract the current totals
+}
+
+std::string metrics_prometheus() { // Function to render the Prometheus text format
+    MetricsSnapshot snapshot = metrics_snapshot(); // Current totals
+    std::string out; // Exposition text
+    for (size_t c = 0; c < kCounterCount; ++c) { // One counter family each
+        append_line(out, "# HELP lattice_crypto_%s_total %s\n", kCounterNames[c], kCounterHelp[c]); // Help
+        append_line(out, "# TYPE lattice_crypto_%s_total counter\n", kCounterNames[c]); // Type
+        append_line(out, "lattice_crypto_%s_total %llu\n", kCounterNames[c], static_cast<unsigned long long>(snapshot.counters[c])); // Value
+    }
+    for (size_t h = 0; h < kHistogramCount; ++h) { // One histogram family each
+        const HistogramSnapshot& histogram = snapshot.histograms[h]; // Histogram to render
+        const char* name = kHistogramNames[h]; // Family name
+        append_line(out, "# HELP lattice_crypto_%s_seconds %s\n", name, kHistogramHelp[h]); // Help
+        append_line(out, "# TYPE lattice_crypto_%s_seconds histogram\n", name); // Type
+        uint64_t cumulative = 0; // Events below the current bound
+        size_t bucket = 0; // Next bucket to add
+        for (int exponent = kPrometheusFirstExponent; exponent <= kPrometheusLastExponent; ++exponent) { // Powers of two fall on bucket edges
+            const uint64_t bound = uint64_t(1) << exponent; // Bound in nanoseconds
+            while (bucket < kHistogramBuckets && histogram_bucket_upper(bucket) <= bound) cumulative += histogram.buckets[bucket++]; // Buckets below it
+            append_line(out, "lattice_crypto_%s_seconds_bucket{le=\"%.9g\"} %llu\n", name, static_cast<double>(bound) * 1e-9,
+                        static_cast<unsigned long long>(cumulative)); // Cumulative count
+        }
+        append_line(out, "lattice_crypto_%s_seconds_bucket{le=\"+Inf\"} %llu\n", name, static_cast<unsigned long long>(histogram.count)); // Every event
+        append_line(out, "lattice_crypto_%s_seconds_sum %.9g\n", name, static_cast<double>(histogram.sum_ns) * 1e-9); // Total time
+        append_line(out, "lattice_crypto_%s_seconds_count %llu\n", name, static_cast<unsigned long long>(histogram.count)); // Events
+    }
+    return out; // Return the text
+}
+
+}  // namespace lattice_crypto
@@ -0,0 +1,72 @@
+#include "ntt_kernels.h"  // Include the header file for declarations
+#include "ntt_kernels_internal.h"  // Scalar building blocks shared with the SIMD kernels
+#include <stdexcept>  // For std::invalid_argument
+#include <string>  // For std::to_string
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+// Portable butterflies: every stage in scalar code
+void scalar_butterflies(int32_t* a, int n, const int32_t* twiddles, const Modulus& mod) { // Scalar transform stages
+    for (int half = 1; half < n; half <<= 1) { // Loop through each stage
+        detail::scalar_stage(a, n, half, twiddles + half - 1, mod); // Run the stage
+    }
+}
+
+// Portable pointwise product
+void scalar_pointwise(const int32_t* a, const int32_t* b, int32_t* out, int n, const Modulus& mod) { // Scalar pointwise product
+    detail::scalar_pointwise(a, b, out, 0, n, mod); // Whole range in scalar code
+}
+
+const NttKernels scalar_kernels = {KernelIsa::scalar, "scalar", scalar_butterflies, scalar_pointwise}; // Always available
+
+// Ask the CPU whether it can run the given kernels
+bool cpu_supports(KernelIsa isa) { // Function to query CPUID
+#if defined(LATTICE_CRYPTO_X86_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    switch (isa) { // Check the requested instruction set
+        case KernelIsa::scalar: return true; // Scalar code runs everywhere
+        case KernelIsa::avx2: return __builtin_cpu_supports("avx2"); // AVX2 kernels
+        case KernelIsa::avx512: return __builtin_cpu_supports("avx512f"); // AVX-512F kernels
+    }
+    return false; // Unknown instruction set
+#else
+    return isa == KernelIsa::scalar; // Only the portable kernels are built in
+#endif
+}
+
+} // End of anonymous namespace
+
+Modulus make_modulus(int q) { // Function to build the Barrett constants
+    if (q < 2 || q >= (1 << 16)) { // Products of two coefficients must fit in 32 bits
+        throw std::invalid_argument("Modulus " + std::to_string(q) + " must be in [2, 65536)"); // Reject the modulus
+    }
+    Modulus mod; // Result
+    mod.q = static_cast<uint32_t>(q); // Modulus value
+    mod.barrett = static_cast<uint32_t>((uint64_t(1) << 32) / static_cast<uint64_t>(q)); // floor(2^32 / q)
+    return mod; // Return the constants
+}
+
+const NttKernels* kernels_for(KernelIsa isa) { // Function to look up kernels by instruction set
+    if (!cpu_supports(isa)) return nullptr; // Not runnable here
+    switch (isa) { // Pick the table
+        case KernelIsa::scalar: return &scalar_kernels; // Portable kernels
+#ifdef LATTICE_CRYPTO_X86_KERNELS
+        case KernelIsa::avx2: return &detail::avx2_kernels; // AVX2 kernels
+        case KernelIsa::avx512: return &detail::avx512_kernels; // AVX-512 kernels
+#endif
+        default: return nullptr; // Not built in
+    }
+}
+
+const NttKernels& active_kernels() { // Function to pick the fastest kernels once
+    static const NttKernels& kernels = []() -> const NttKernels& { // Detect on first use
+        for (KernelIsa isa : {KernelIsa::avx512, KernelIsa::avx2}) { // Widest first
+            if (const NttKernels* candidate = kernels_for(isa)) return *candidate; // Use the first supported set
+        }
+        return scalar_kernels; // Fall back to portable code
+    }();
+    return kernels; // Return the cached choice
+}
+
+}  // namespace lattice_crypto
@@ -0,0 +1,69 @@
+// AVX2 kernels; this translation unit is compiled with -mavx2 and only entered after a CPUID check
+#include "ntt_kernels.h"  // Include the header file for declarations
+#include "ntt_kernels_internal.h"  // Scalar building blocks for short stages and tails
+#include <immintrin.h>  // AVX2 intrinsics
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+constexpr int kLanes = 8; // 32-bit lanes per register
+
+// Barrett multiplication of eight lanes in [0, q)
+inline __m256i mul_mod(__m256i a, __m256i b, __m256i q, __m256i barrett) { // Vector Barrett product
+    __m256i x = _mm256_mullo_epi32(a, b); // Exact 32-bit products
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, barrett), 32); // High halves of x * barrett, even lanes
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), barrett); // x * barrett for odd lanes, high half already in place
+    __m256i t = _mm256_blend_epi32(even, odd, 0xAA); // floor(x / q) or one less, per lane
+    __m256i r = _mm256_sub_epi32(x, _mm256_mullo_epi32(t, q)); // In [0, 2q)
+    return _mm256_min_epu32(r, _mm256_sub_epi32(r, q)); // Subtract q when r >= q
+}
+
+// Reduce lanes in [0, 2q) into [0, q)
+inline __m256i reduce_once(__m256i x, __m256i q) { // Conditional subtraction
+    return _mm256_min_epu32(x, _mm256_sub_epi32(x, q)); // x - q wraps around when x < q
+}
+
+void avx2_butterflies(int32_t* a, int n, const int32_t* twiddles, const Modulus& mod) { // AVX2 transform stages
+    const __m256i q = _mm256_set1_epi32(static_cast<int>(mod.q)); // Broadcast modulus
+    const __m256i barrett = _mm256_set1_epi32(static_cast<int>(mod.barrett)); // Broadcast Barrett constant
+    int half = 1; // Current half-length
+    for (; half < n && half < kLanes; half <<= 1) { // Stages narrower than a register
+        detail::scalar_stage(a, n, half, twiddles + half - 1, mod); // Run them in scalar code
+    }
+    for (; half < n; half <<= 1) { // Full-width stages
+        const int32_t* w = twiddles + half - 1; // Twiddles of this stage
+        for (int i = 0; i < n; i += 2 * half) { // Loop through each block
+            for (int j = 0; j < half; j += kLanes) { // Eight butterflies at a time
+                __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + j)); // Top inputs
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + j + half)); // Bottom inputs
+                __m256i tw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + j)); // Twiddles
+                v = mul_mod(v, tw, q, barrett); // Bottom inputs times twiddles
+                __m256i sum = reduce_once(_mm256_add_epi32(u, v), q); // Butterfly sum
+                __m256i diff = reduce_once(_mm256_sub_epi32(_mm256_add_epi32(u, q), v), q); // Butterfly difference
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i + j), sum); // Store the sums
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i + j + half), diff); // Store the differences
+            }
+        }
+    }
+}
+
+void avx2_pointwise(const int32_t* a, const int32_t* b, int32_t* out, int n, const Modulus& mod) { // AVX2 pointwise product
+    const __m256i q = _mm256_set1_epi32(static_cast<int>(mod.q)); // Broadcast modulus
+    const __m256i barrett = _mm256_set1_epi32(static_cast<int>(mod.barrett)); // Broadcast Barrett constant
+    int i = 0; // Current coefficient
+    for (; i + kLanes <= n; i += kLanes) { // Eight coefficients at a time
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)); // Load a
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)); // Load b
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), mul_mod(x, y, q, barrett)); // Store the products
+    }
+    detail::scalar_pointwise(a, b, out, i, n, mod); // Remaining tail
+}
+
+} // End of anonymous namespace
+
+namespace detail { // Kernel table exported to the dispatcher
+const NttKernels avx2_kernels = {KernelIsa::avx2, "avx2", avx2_butterflies, avx2_pointwise}; // AVX2 kernel table
+} // namespace detail
+
+}  // namespace lattice_crypto
@@ -0,0 +1,105 @@
+// AVX-512 kernels; this translation unit is compiled with -mavx512f and only entered after a CPUID check
+#include "ntt_kernels.h"  // Include the header file for declarations
+#include "ntt_kernels_internal.h"  // Scalar building blocks for short stages and tails
+#include <immintrin.h>  // AVX-512 intrinsics
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+constexpr int kLanes = 16; // 32-bit lanes per register
+constexpr __mmask16 kAllLanes = 0xFFFF; // The zero-masking permute avoids GCC's uninitialized-source warning on the plain one
+
+// Barrett multiplication of sixteen lanes in [0, q)
+inline __m512i mul_mod(__m512i a, __m512i b, __m512i q, __m512i barrett) { // Vector Barrett product
+    __m512i x = _mm512_mullo_epi32(a, b); // Exact 32-bit products
+    __m512i even = _mm512_srli_epi64(_mm512_mul_epu32(x, barrett), 32); // High halves of x * barrett, even lanes
+    __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(x, 32), barrett); // x * barrett for odd lanes, high half already in place
+    __m512i t = _mm512_mask_blend_epi32(0xAAAA, even, odd); // floor(x / q) or one less, per lane
+    __m512i r = _mm512_sub_epi32(x, _mm512_mullo_epi32(t, q)); // In [0, 2q)
+    return _mm512_min_epu32(r, _mm512_sub_epi32(r, q)); // Subtract q when r >= q
+}
+
+// Reduce lanes in [0, 2q) into [0, q)
+inline __m512i reduce_once(__m512i x, __m512i q) { // Conditional subtraction
+    return _mm512_min_epu32(x, _mm512_sub_epi32(x, q)); // x - q wraps around when x < q
+}
+
+// Runs the stages of half-length 1, 2, 4 and 8 inside each register of sixteen coefficients; n is at least 16.
+// Every lane is paired with lane ^ half, so one permute brings both butterfly inputs together, and the top lanes
+// keep the sums while the bottom lanes keep the differences.
+void narrow_stages(int32_t* a, int n, const int32_t* twiddles, __m512i q, __m512i barrett) { // In-register short stages
+    constexpr int kStages = 4; // half = 1, 2, 4, 8
+    const __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); // Lane numbers
+    __m512i partner[kStages]; // Lane holding the other input of each butterfly
+    __m512i tw[kStages]; // Twiddle of each lane
+    __mmask16 bottom[kStages]; // Lanes holding the bottom inputs
+    for (int s = 0, half = 1; s < kStages; ++s, half <<= 1) { // Per-stage constants, built once per transform
+        const __m512i bit = _mm512_set1_epi32(half); // Lane bit that tells top from bottom
+        partner[s] = _mm512_xor_si512(lane, bit); // Partner lane
+        bottom[s] = _mm512_test_epi32_mask(lane, bit); // Bottom lanes
+        __m512i w = _mm512_maskz_loadu_epi32(static_cast<__mmask16>((1 << half) - 1), twiddles + half - 1); // The stage's twiddles
+        tw[s] = _mm512_maskz_permutexvar_epi32(kAllLanes, _mm512_and_si512(lane, _mm512_set1_epi32(half - 1)), w); // Repeated for every block
+    }
+    for (int i = 0; i < n; i += kLanes) { // One register at a time, loaded and stored once for all four stages
+        __m512i x = _mm512_loadu_si512(a + i); // Sixteen coefficients
+        for (int s = 0; s < kStages; ++s) { // Every short stage
+            __m512i y = _mm512_maskz_permutexvar_epi32(kAllLanes, partner[s], x); // Partners side by side
+            __m512i u = _mm512_mask_blend_epi32(bottom[s], x, y); // Top input in every lane
+            __m512i v = _mm512_mask_blend_epi32(bottom[s], y, x); // Bottom input in every lane
+            v = mul_mod(v, tw[s], q, barrett); // Bottom inputs times twiddles
+            __m512i sum = reduce_once(_mm512_add_epi32(u, v), q); // Butterfly sum
+            __m512i diff = reduce_once(_mm512_sub_epi32(_mm512_add_epi32(u, q), v), q); // Butterfly difference
+            x = _mm512_mask_blend_epi32(bottom[s], sum, diff); // Sums on top, differences below
+        }
+        _mm512_storeu_si512(a + i, x); // Store the register
+    }
+}
+
+void avx512_butterflies(int32_t* a, int n, const int32_t* twiddles, const Modulus& mod) { // AVX-512 transform stages
+    const __m512i q = _mm512_set1_epi32(static_cast<int>(mod.q)); // Broadcast modulus
+    const __m512i barrett = _mm512_set1_epi32(static_cast<int>(mod.barrett)); // Broadcast Barrett constant
+    int half = 1; // Current half-length
+    if (n >= kLanes) { // Whole registers
+        narrow_stages(a, n, twiddles, q, barrett); // Stages narrower than a register, vectorized in place
+        half = kLanes; // Continue with the full-width stages
+    }
+    for (; half < n && half < kLanes; half <<= 1) { // Transforms shorter than a register
+        detail::scalar_stage(a, n, half, twiddles + half - 1, mod); // Run them in scalar code
+    }
+    for (; half < n; half <<= 1) { // Full-width stages
+        const int32_t* w = twiddles + half - 1; // Twiddles of this stage
+        for (int i = 0; i < n; i += 2 * half) { // Loop through each block
+            for (int j = 0; j < half; j += kLanes) { // Sixteen butterflies at a time
+                __m512i u = _mm512_loadu_si512(a + i + j); // Top inputs
+                __m512i v = _mm512_loadu_si512(a + i + j + half); // Bottom inputs
+                __m512i tw = _mm512_loadu_si512(w + j); // Twiddles
+                v = mul_mod(v, tw, q, barrett); // Bottom inputs times twiddles
+                __m512i sum = reduce_once(_mm512_add_epi32(u, v), q); // Butterfly sum
+                __m512i diff = reduce_once(_mm512_sub_epi32(_mm512_add_epi32(u, q), v), q); // Butterfly difference
+                _mm512_storeu_si512(a + i + j, sum); // Store the sums
+                _mm512_storeu_si512(a + i + j + half, diff); // Store the differences
+            }
+        }
+    }
+}
+
+void avx512_pointwise(const int32_t* a, const int32_t* b, int32_t* out, int n, const Modulus& mod) { // AVX-512 pointwise product
+    const __m512i q = _mm512_set1_epi32(static_cast<int>(mod.q)); // Broadcast modulus
+    const __m512i barrett = _mm512_set1_epi32(static_cast<int>(mod.barrett)); // Broadcast Barrett constant
+    int i = 0; // Current coefficient
+    for (; i + kLanes <= n; i += kLanes) { // Sixteen coefficients at a time
+        __m512i x = _mm512_loadu_si512(a + i); // Load a
+        __m512i y = _mm512_loadu_si512(b + i); // Load b
+        _mm512_storeu_si512(out + i, mul_mod(x, y, q, barrett)); // Store the products
+    }
+    detail::scalar_pointwise(a, b, out, i, n, mod); // Remaining tail
+}
+
+} // End of anonymous namespace
+
+namespace detail { // Kernel table exported to the dispatcher
+const NttKernels avx512_kernels = {KernelIsa::avx512, "avx512", avx512_butterflies, avx512_pointwise}; // AVX-512 kernel table
+} // namespace detail
+
+}  // namespace lattice_crypto
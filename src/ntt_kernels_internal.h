@@ -0,0 +1,50 @@
+#ifndef NTT_KERNELS_INTERNAL_H
+#define NTT_KERNELS_INTERNAL_H
+
+#include "ntt_kernels.h"
+
+namespace lattice_crypto {
+namespace detail {
+
+// Helpers are static so that each ISA-specific translation unit keeps its own copy;
+// a shared inline definition could otherwise be merged with one compiled for a wider ISA
+
+// Barrett multiplication of two values in [0, q); the result is fully reduced into [0, q)
+static inline uint32_t mul_mod(uint32_t a, uint32_t b, const Modulus& mod) {
+    uint32_t x = a * b;  // Exact, since a, b < 2^16
+    uint32_t t = static_cast<uint32_t>((static_cast<uint64_t>(x) * mod.barrett) >> 32);  // floor(x / q) or one less
+    uint32_t r = x - t * mod.q;  // In [0, 2q)
+    return r >= mod.q ? r - mod.q : r;  // Final correction
+}
+
+// One butterfly stage of half-length 'half' over the whole array, in scalar code
+static inline void scalar_stage(int32_t* a, int n, int half, const int32_t* w, const Modulus& mod) {
+    for (int i = 0; i < n; i += 2 * half) {
+        for (int j = 0; j < half; ++j) {
+            uint32_t u = static_cast<uint32_t>(a[i + j]);
+            uint32_t v = mul_mod(static_cast<uint32_t>(a[i + j + half]), static_cast<uint32_t>(w[j]), mod);
+            uint32_t sum = u + v;
+            uint32_t diff = u + mod.q - v;
+            a[i + j] = static_cast<int32_t>(sum >= mod.q ? sum - mod.q : sum);
+            a[i + j + half] = static_cast<int32_t>(diff >= mod.q ? diff - mod.q : diff);
+        }
+    }
+}
+
+// Scalar pointwise product over [begin, n)
+static inline void scalar_pointwise(const int32_t* a, const int32_t* b, int32_t* out, int begin, int n, const Modulus& mod) {
+    for (int i = begin; i < n; ++i) {
+        out[i] = static_cast<int32_t>(mul_mod(static_cast<uint32_t>(a[i]), static_cast<uint32_t>(b[i]), mod));
+    }
+}
+
+#ifdef LATTICE_CRYPTO_X86_KERNELS
+// Kernel tables defined in the ISA-specific translation units
+extern const NttKernels avx2_kernels;
+extern const NttKernels avx512_kernels;
+#endif
+
+}  // namespace detail
+}  // namespace lattice_crypto
+
+#endif  // NTT_KERNELS_INTERNAL_H
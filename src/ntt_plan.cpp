@@ -0,0 +1,136 @@
+#include "ntt_plan.h"  // Include the header file for declarations
+#include <stdexcept>  // For std::invalid_argument
+#include <string>  // For std::to_string
+#include <utility>  // For std::swap
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+// Modular exponentiation used while building the tables
+int32_t pow_mod(int64_t base, int64_t exp, int64_t mod) { // Square-and-multiply
+    int64_t result = 1; // Initialize result to 1
+    base %= mod; // Always reduce base modulo
+    while (exp > 0) { // Loop until all exponent bits are consumed
+        if (exp & 1) result = (result * base) % mod; // Multiply in the current bit
+        base = (base * base) % mod; // Square the base
+        exp >>= 1; // Move to the next bit
+    }
+    return static_cast<int32_t>(result); // Return the reduced result
+}
+
+// Trial division is plenty for the 16-bit moduli the scheme uses
+bool is_prime(int value) { // Function to test primality
+    if (value < 2) return false; // 0 and 1 are not prime
+    for (int d = 2; 1LL * d * d <= value; ++d) { // Check every candidate divisor up to sqrt(value)
+        if (value % d == 0) return false; // Found a divisor
+    }
+    return true; // No divisor found
+}
+
+// Reverse the lowest 'log_n' bits of a number
+int reverse_bits(int num, int log_n) { // Function to reverse bits of a number
+    int reversed = 0; // Initialize reversed number to 0
+    for (int i = 0; i < log_n; ++i) { // Loop through each bit
+        if (num & (1 << i)) reversed |= 1 << (log_n - 1 - i); // Reverse the bit
+    }
+    return reversed; // Return the reversed number
+}
+
+// Fill a stage-major twiddle table of n - 1 entries for the cyclic transform of size n with root omega
+void build_twiddles(int32_t* twiddles, int n, int omega, int q) { // Function to build stage twiddles
+    for (int half = 1; half < n; half <<= 1) { // Loop through each stage
+        int32_t w_length = pow_mod(omega, n / (2 * half), q); // Root of unity of order 2 * half
+        int32_t w = 1; // Initialize w to 1
+        for (int j = 0; j < half; ++j) { // Loop through each butterfly column of the stage
+            twiddles[half - 1 + j] = w; // Store the twiddle
+            w = static_cast<int32_t>((1LL * w * w_length) % q); // Advance to the next power
+        }
+    }
+}
+
+} // End of anonymous namespace
+
+NttPlan::NttPlan(int n, int q, const NttKernels& kernels) // Constructor validating the parameters
+    : n(n), q(q), psi(0), inv_n(0), mod(make_modulus(q)), kernels(&kernels) { // make_modulus rejects q >= 2^16
+    if (n < 2 || (n & (n - 1)) != 0) { // Check that n is a power of two
+        throw std::invalid_argument("NTT size must be a power of two, got " + std::to_string(n)); // Reject the size
+    }
+    if (!is_prime(q) || (q - 1) % (2 * n) != 0) { // Check that Z_q has a primitive 2n-th root of unity
+        throw std::invalid_argument("Modulus " + std::to_string(q) + " is not NTT-friendly for n = " + std::to_string(n)); // Reject the modulus
+    }
+
+    for (int g = 2; g < q; ++g) { // Search for the smallest primitive 2n-th root
+        if (pow_mod(g, n, q) == q - 1) { // g^n = -1 means g has order exactly 2n
+            psi = g; // Keep the root
+            break; // Stop searching
+        }
+    }
+
+    // One allocation holds every table: bit reversal, twist, untwist (n each) and both twiddle sets (n - 1 each)
+    storage.resize(5 * static_cast<size_t>(n) - 2); // Backing store for all tables
+    int32_t* bit_reversal_table = storage.data(); // n entries
+    int32_t* twist_table = bit_reversal_table + n; // n entries
+    int32_t* untwist_table = twist_table + n; // n entries
+    int32_t* forward_table = untwist_table + n; // n - 1 entries
+    int32_t* inverse_table = forward_table + (n - 1); // n - 1 entries
+
+    int log_n = 0; // Number of bits in an index
+    while ((1 << log_n) < n) ++log_n; // Calculate log base 2 of n
+    for (int i = 0; i < n; ++i) { // Loop through each index
+        bit_reversal_table[i] = reverse_bits(i, log_n); // Reverse the bits once, up front
+    }
+
+    int omega = pow_mod(psi, 2, q); // Primitive n-th root for the cyclic part
+    int inv_psi = pow_mod(psi, q - 2, q); // Fermat's Little Theorem
+    int inv_omega = pow_mod(inv_psi, 2, q); // Inverse of omega
+    inv_n = pow_mod(n, q - 2, q); // Fermat's Little Theorem
+
+    build_twiddles(forward_table, n, omega, q); // Forward stage twiddles
+    build_twiddles(inverse_table, n, inv_omega, q); // Inverse stage twiddles
+
+    int64_t psi_i = 1; // Running power of psi
+    int64_t inv_psi_i = inv_n; // Running power of psi^-1, pre-scaled by n^-1
+    for (int i = 0; i < n; ++i) { // Loop through each coefficient
+        twist_table[i] = static_cast<int32_t>(psi_i); // Store psi^i
+        untwist_table[i] = static_cast<int32_t>(inv_psi_i); // Store n^-1 * psi^-i
+        psi_i = (psi_i * psi) % q; // Advance psi^i
+        inv_psi_i = (inv_psi_i * inv_psi) % q; // Advance psi^-i
+    }
+
+    bit_reversal = bit_reversal_table; // Publish the tables
+    twist = twist_table;
+    untwist = untwist_table;
+    forward_twiddles = forward_table;
+    inverse_twiddles = inverse_table;
+}
+
+NttPlan::NttPlan(const NttTableView& tables, const NttKernels& kernels) // Constructor wrapping external tables
+    : n(tables.n), q(tables.q), psi(tables.psi), inv_n(tables.inv_n), mod(make_modulus(tables.q)), kernels(&kernels),
+      bit_reversal(tables.bit_reversal), forward_twiddles(tables.forward_twiddles), inverse_twiddles(tables.inverse_twiddles),
+      twist(tables.twist), untwist(tables.untwist) {} // Nothing to compute
+
+void NttPlan::permute(int32_t* a) const { // Bit-reversal permutation
+    for (int i = 0; i < n; ++i) { // Apply the permutation in place
+        int j = bit_reversal[i]; // Partner index
+        if (i < j) std::swap(a[i], a[j]); // Swap each pair once
+    }
+}
+
+void NttPlan::forward(int32_t* a) const { // Forward negacyclic transform
+    kernels->pointwise(a, twist, a, n, mod); // Twist by psi^i
+    permute(a); // Bit-reverse the input order
+    kernels->butterflies(a, n, forward_twiddles, mod); // Cyclic transform
+}
+
+void NttPlan::inverse(int32_t* a) const { // Inverse negacyclic transform
+    permute(a); // Bit-reverse the input order
+    kernels->butterflies(a, n, inverse_twiddles, mod); // Cyclic inverse transform
+    kernels->pointwise(a, untwist, a, n, mod); // Untwist and scale by n^-1
+}
+
+void NttPlan::pointwise(const int32_t* a, const int32_t* b, int32_t* out) const { // Coefficient-wise product
+    kernels->pointwise(a, b, out, n, mod); // Multiply and reduce
+}
+
+}  // namespace lattice_crypto
@@ -0,0 +1,121 @@
+#include "randomness_pool.h"  // Include the header file for declarations
+#include "crypto_log.h"  // Leveled asynchronous logging
+#include "metrics.h"  // Counters and latency histograms
+#include <openssl/crypto.h>  // For OPENSSL_cleanse
+#include <algorithm>  // For std::copy and std::min
+#include <chrono>  // For the refill thread's poll interval
+#include <exception>  // For std::exception
+#include <stdexcept>  // For std::invalid_argument
+#include <string>  // For std::to_string
+#include <unistd.h>  // For getpid
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+constexpr size_t kMaxPoolDepth = size_t(1) << 20; // Upper bound on entries, far above any useful depth
+constexpr auto kRefillPoll = std::chrono::milliseconds(50); // Longest the refill thread sleeps without checking the pool
+constexpr auto kRefillBackoff = std::chrono::milliseconds(500); // Pause after a failed refill
+
+} // End of anonymous namespace
+
+RandomnessPool::RandomnessPool(RingLWEEngine& engine, const RandomnessPoolOptions& options) // Constructor preparing the slab
+    : engine(engine), // Engine computing the entries
+      options(options), // Depth and refill policy
+      n(static_cast<size_t>(engine.degree())), // Coefficients per polynomial
+      ready_slots(options.depth), // Room for every entry
+      free_slots(options.depth), // Room for every entry
+      owner(getpid()), // Entries belong to this process
+      refiller(new Refiller) { // Sleep state, with or without the thread
+    if (options.depth == 0 || options.depth > kMaxPoolDepth) { // Check the depth
+        throw std::invalid_argument("Randomness pool depth must be in [1, " + std::to_string(kMaxPoolDepth) + "]."); // Throw invalid argument
+    }
+    this->options.refill_below = std::min(options.refill_below, options.depth); // Never wait for more than the pool holds
+    slab.assign(options.depth * 2 * n, 0); // Every entry, allocated once
+    for (size_t i = 0; i < options.depth; ++i) free_slots.try_push(static_cast<uint32_t>(i)); // Every slot starts empty
+    CRYPTO_LOG(info) << "Randomness pool of " << options.depth << " entries for " << engine.name() <<
+        (options.background ? ", refilled in the background" : ""); // Log the setup
+    if (options.background) refiller->thread = std::thread(&RandomnessPool::run, this); // Start filling
+}
+
+RandomnessPool::~RandomnessPool() { // Destructor stopping the refill thread
+    if (owner != getpid()) { // Forked child: the refill thread and its waiters only exist in the parent
+        (void)refiller.release(); // Leak the inherited copy; waking, joining or destroying it would wait on the parent's thread
+        OPENSSL_cleanse(slab.data(), slab.size() * sizeof(int32_t)); // Still wipe the inherited entries
+        return; // Nothing else to stop
+    }
+    {
+        std::lock_guard<std::mutex> lock(refiller->wake_mutex); // Publish the stop flag
+        stopping.store(true); // Ask the refill thread to exit
+    }
+    refiller->wake.notify_one(); // Wake it
+    if (refiller->thread.joinable()) refiller->thread.join(); // Wait for it
+    OPENSSL_cleanse(slab.data(), slab.size() * sizeof(int32_t)); // Entries mask plaintexts; never leave them in freed memory
+}
+
+void RandomnessPool::encrypt_into(std::string_view plaintext, Ciphertext& out) { // Function to encrypt from the pool
+    if (plaintext.size() > engine.max_plaintext_size()) { // Check before an entry is spent
+        throw std::invalid_argument("Plaintext is too long for the polynomial degree."); // Throw invalid argument
+    }
+    if (out.first.size() != n) out.first = RingElement(n); // Only allocates for a fresh ciphertext
+    if (out.second.size() != n) out.second = RingElement(n); // Only allocates for a fresh ciphertext
+
+    uint32_t slot; // Entry to use
+    if (owner == getpid() && ready_slots.try_pop(slot)) { // Hit; a forked child never takes the parent's entries
+        CRYPTO_METRIC_TIMER(encrypt); // Time the online encryption
+        CRYPTO_METRIC_COUNT(pool_hits, 1); // Count the hit
+        const size_t remaining = available.fetch_sub(1, std::memory_order_relaxed) - 1; // Entries left
+        int32_t* entry = slab.data() + static_cast<size_t>(slot) * 2 * n; // (c1, mask)
+        std::copy(entry, entry + n, out.first.data()); // c1
+        std::copy(entry + n, entry + 2 * n, out.second.data()); // b * r + e2
+        OPENSSL_cleanse(entry, 2 * n * sizeof(int32_t)); // Each entry is used exactly once
+        free_slots.try_push(slot); // Back for refilling; never full, since every slot is in one queue at a time
+        if (remaining < options.refill_below) refiller->wake.notify_one(); // Running low
+        engine.add_message(plaintext, out.second.data()); // c2 = b * r + e2 + m
+        return; // Done
+    }
+    CRYPTO_METRIC_COUNT(pool_misses, 1); // Count the miss
+    engine.encrypt_into(plaintext, out); // Full encryption on the caller's thread
+}
+
+size_t RandomnessPool::refill() { // Function to fill the pool on the calling thread
+    if (owner != getpid()) return 0; // Entries made here would never be used
+    size_t added = 0; // Entries computed
+    uint32_t slot; // Slot being filled
+    while (!stopping.load(std::memory_order_relaxed) && free_slots.try_pop(slot)) { // Until the pool is full
+        int32_t* entry = slab.data() + static_cast<size_t>(slot) * 2 * n; // (c1, mask)
+        try { // Give the slot back when the engine fails
+            engine.encrypt_randomness(entry, entry + n); // Everything but the message
+        } catch (...) { // Sampling failed
+            free_slots.try_push(slot); // Keep the slot
+            throw; // Rethrow
+        }
+        available.fetch_add(1, std::memory_order_relaxed); // Count it first, so a taker can never see the count below zero
+        ready_slots.try_push(slot); // Publish the entry; the queue's release store orders the writes above
+        CRYPTO_METRIC_COUNT(pool_precomputed, 1); // Count the work
+        ++added; // Count it here too
+    }
+    return added; // Return the number of entries added
+}
+
+void RandomnessPool::run() { // Refill thread loop
+    while (!stopping.load()) { // Until the destructor runs
+        if (available.load(std::memory_order_relaxed) < options.refill_below) { // Running low
+            try { // The thread must not die on a failed refill
+                size_t added = refill(); // Top up to the full depth
+                CRYPTO_LOG(trace) << "Randomness pool refilled with " << added << " entries"; // Log the refill
+            } catch (const std::exception& e) { // Sampling failed
+                CRYPTO_LOG(error) << "Randomness pool refill failed: " << e.what(); // Log the failure
+                std::unique_lock<std::mutex> lock(refiller->wake_mutex); // Sleep on the same condition
+                refiller->wake.wait_for(lock, kRefillBackoff, [&] { return stopping.load(); }); // Back off before retrying
+            }
+            continue; // Check again
+        }
+        std::unique_lock<std::mutex> lock(refiller->wake_mutex); // Coordinate with the destructor
+        refiller->wake.wait_for(lock, kRefillPoll, [&] { // Sleep until woken, or poll in case a wake-up raced the sleep
+            return stopping.load() || available.load(std::memory_order_relaxed) < options.refill_below; // Stop or refill
+        });
+    }
+}
+
+}  // namespace lattice_crypto
@@ -0,0 +1,249 @@
+#include "ring_lwe.h"  // Include the header file for declarations
+#include "lattice_crypto.h"  // For KeyGenerator
+#include "lattice_crypto_internal.h"  // Helpers shared with the runtime wrapper
+#include "ring_lwe_fixed.h"  // Scalar transforms specialized on the parameter set
+#include "crypto_log.h"  // Leveled asynchronous logging
+#include "metrics.h"  // Counters and latency histograms
+#include "sampler.h"  // Block-buffered random sampling
+#include "workspace.h"  // Per-thread scratch buffers
+#include <algorithm>  // For std::copy
+#include <stdexcept>  // For std::invalid_argument and std::logic_error
+#include <utility>  // For std::move
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+// Each plaintext byte is spread over two coefficients, one nibble per coefficient
+constexpr int kBitsPerCoefficient = 4; // Message bits carried by one coefficient
+constexpr int kNibbleLevels = 1 << kBitsPerCoefficient; // Distinct values one coefficient encodes
+
+} // End of anonymous namespace
+
+template <class P>
+RingLWE<P>::RingLWE(const NttKernels& kernels) // Constructor generating a key pair
+    : ntt_plan(std::make_shared<const NttPlan>(Tables::view(), kernels)), // Plan over the constexpr tables, nothing computed here
+      use_fixed_scalar(ntt_plan->kernel_set().isa == KernelIsa::scalar), // Prefer SIMD kernels when present
+      key_gen(new KeyGenerator(ntt_plan)) { // Share the plan with the key generator
+    CRYPTO_LOG(info) << "Initializing RingLWE engine " << P::name << " on " << ntt_plan->kernel_set().name << " kernels"; // Log the initialization
+    CRYPTO_METRIC_TIMER(keygen); // Time the key pair generation
+    RingElement secret = key_gen->generate_random_polynomial(N); // Generate secret key
+    std::pair<RingElement, RingElement> public_key_pair = key_gen->generate_keys(secret, q); // Generate public key pair
+    secret_key = RingKey(std::move(secret)); // Assign secret key
+    public_key.first = RingKey(std::move(public_key_pair.first)); // Assign first part of public key
+    public_key.second = RingKey(std::move(public_key_pair.second)); // Assign second part of public key
+
+    CRYPTO_LOG(debug) << "Generated key pair: secret " << secret_key << ", public (" << public_key.first << ", " << public_key.second << ")"; // Shapes only, the keys are redacted
+}
+
+template <class P>
+RingLWE<P>::RingLWE(RingKey secret, std::pair<RingKey, RingKey> public_keys) // Constructor over an existing key pair
+    : ntt_plan(std::make_shared<const NttPlan>(Tables::view())), // Plan over the constexpr tables, nothing computed here
+      use_fixed_scalar(ntt_plan->kernel_set().isa == KernelIsa::scalar), // Prefer SIMD kernels when present
+      key_gen(new KeyGenerator(ntt_plan)), // Share the plan with the key generator
+      secret_key(std::move(secret)), // Secret key, possibly empty
+      public_key(std::move(public_keys)) { // Public key pair
+    const size_t n = static_cast<size_t>(N); // Expected key size
+    if (public_key.first.size() != n || public_key.second.size() != n || (!secret_key.empty() && secret_key.size() != n)) { // Check the key shapes
+        CRYPTO_LOG(error) << "Key sizes do not match parameter set " << P::name; // Log the error
+        throw std::invalid_argument("Key sizes do not match the polynomial degree."); // Throw invalid argument
+    }
+    CRYPTO_LOG(info) << "Loaded RingLWE engine " << P::name << " on " << ntt_plan->kernel_set().name << " kernels" <<
+        (secret_key.empty() ? " (encrypt only)" : ""); // Log the initialization
+}
+
+template <class P>
+RingLWE<P>::~RingLWE() = default; // KeyGenerator is complete here
+
+template <class P>
+void RingLWE<P>::forward(int32_t* a) const { // Forward negacyclic transform
+    CRYPTO_METRIC_TIMER(ntt); // Time the transform
+    if (!use_fixed_scalar) { // SIMD kernels over the same tables
+        ntt_plan->forward(a); // Dispatch to the plan
+        return; // Done
+    }
+    fixed_forward<P>(a); // Specialized scalar transform
+}
+
+template <class P>
+void RingLWE<P>::inverse(int32_t* a) const { // Inverse negacyclic transform
+    CRYPTO_METRIC_TIMER(ntt); // Time the transform
+    if (!use_fixed_scalar) { // SIMD kernels over the same tables
+        ntt_plan->inverse(a); // Dispatch to the plan
+        return; // Done
+    }
+    fixed_inverse<P>(a); // Specialized scalar inverse transform
+}
+
+template <class P>
+void RingLWE<P>::multiply_by_key(const RingKey& key, const int32_t* operand_ntt, int32_t* product) const { // Function to multiply by a cached key
+    const int32_t* key_ntt = key.ntt_data(*ntt_plan); // Cached or mapped NTT-domain key
+    if (use_fixed_scalar) { // Specialized scalar product
+        fixed_pointwise<P>(key_ntt, operand_ntt, product); // Multiply and reduce
+    } else { // SIMD product
+        ntt_plan->pointwise(key_ntt, operand_ntt, product); // One pointwise product
+    }
+    inverse(product); // One inverse transform
+}
+
+template <class P>
+size_t RingLWE<P>::max_plaintext_size() const { // Function to report the plaintext capacity
+    return static_cast<size_t>(N) * kBitsPerCoefficient / 8; // Two coefficients per byte
+}
+
+template <class P>
+Ciphertext RingLWE<P>::encrypt(std::string_view plaintext) { // Function to encrypt plaintext
+    Ciphertext ciphertext; // Sized by encrypt_into
+    encrypt_into(plaintext, ciphertext); // Encrypt
+    return ciphertext; // Return the ciphertext pair
+}
+
+template <class P>
+void RingLWE<P>::encrypt_into(std::string_view plaintext, Ciphertext& out) { // Function to encrypt into reused storage
+    CRYPTO_LOG(trace) << "Encrypting " << plaintext.size() << "-byte plaintext"; // Log the start of encryption, never the plaintext
+    if (plaintext.size() > max_plaintext_size()) { // Check that the plaintext fits in one ciphertext
+        CRYPTO_LOG(error) << "Plaintext of " << plaintext.size() << " bytes exceeds " << max_plaintext_size() << " bytes."; // Log the error
+        throw std::invalid_argument("Plaintext is too long for the polynomial degree."); // Throw instead of writing out of bounds
+    }
+    CRYPTO_METRIC_TIMER(encrypt); // Time the encryption
+    if (out.first.size() != static_cast<size_t>(N)) out.first = RingElement(N); // Only allocates for a fresh ciphertext
+    if (out.second.size() != static_cast<size_t>(N)) out.second = RingElement(N); // Only allocates for a fresh ciphertext
+    encrypt_randomness(out.first.data(), out.second.data()); // c1 and b * r + e2, written in place
+    add_message(plaintext, out.second.data()); // c2 = b * r + e2 + m
+}
+
+template <class P>
+void RingLWE<P>::encrypt_randomness(int32_t* c1, int32_t* mask) { // Function to compute the message-independent part
+    Workspace& workspace = Workspace::thread_local_instance(); // Scratch for r and the errors
+    Workspace::Scope scope(workspace, Workspace::Release::wipe); // r and e2 would give b * r + e2, and with it the message
+    Sampler& sampler = Sampler::thread_local_instance(); // Per-thread random source
+
+    // r is the only operand that changes per message, so it is transformed once and shared by both products
+    int32_t* r_ntt = workspace.take(N); // Ephemeral secret r
+    sampler.fill_binary(r_ntt, N); // Binary coefficients
+    forward(r_ntt); // Forward transform of r
+    multiply_by_key(public_key.first, r_ntt, c1); // a * r
+    multiply_by_key(public_key.second, r_ntt, mask); // b * r
+    int32_t* error = workspace.take(N); // Error polynomial, reused for e1 and e2
+    sample_error(error, N, q); // e1
+    add_mod(c1, error, N, q); // c1 = a * r + e1
+    sample_error(error, N, q); // e2
+    add_mod(mask, error, N, q); // b * r + e2
+}
+
+template <class P>
+void RingLWE<P>::add_message(std::string_view plaintext, int32_t* mask) const { // Function to add the encoded plaintext
+    if (plaintext.size() > max_plaintext_size()) { // Check that the plaintext fits in one ciphertext
+        throw std::invalid_argument("Plaintext is too long for the polynomial degree."); // Throw instead of writing out of bounds
+    }
+    CRYPTO_METRIC_COUNT(bytes_encrypted, plaintext.size()); // Count the plaintext
+
+    // Add the plaintext one nibble per coefficient, scaled to q / 16 so decryption can round away the noise
+    constexpr int delta = q / kNibbleLevels; // Distance between encoded nibble values
+    for (size_t i = 0; i < plaintext.size(); ++i) { // Loop through each character of plaintext; the padding encodes as zero
+        unsigned char byte = static_cast<unsigned char>(plaintext[i]); // Byte to encode
+        int32_t low = mask[2 * i] + (byte & 0x0f) * delta; // Low nibble
+        int32_t high = mask[2 * i + 1] + (byte >> 4) * delta; // High nibble
+        mask[2 * i] = low >= q ? low - q : low; // c2 = b * r + e2 + m, reduced
+        mask[2 * i + 1] = high >= q ? high - q : high; // c2 = b * r + e2 + m, reduced
+    }
+}
+
+template <class P>
+void RingLWE<P>::decrypt_raw(const Ciphertext& ciphertext, uint8_t* out) { // Function to decrypt every byte slot
+    const RingElement& c1 = ciphertext.first; // First part of ciphertext
+    const RingElement& c2 = ciphertext.second; // Second part of ciphertext
+    if (c1.size() != static_cast<size_t>(N) || c2.size() != static_cast<size_t>(N)) { // Check the ciphertext shape
+        CRYPTO_LOG(error) << "Ciphertext does not match the polynomial degree."; // Log the error
+        throw std::invalid_argument("Ciphertext does not match the polynomial degree."); // Throw invalid argument
+    }
+    if (secret_key.empty()) { // Engines loaded from a public key can only encrypt
+        throw std::logic_error("Decryption needs the secret key."); // Throw logic error
+    }
+    CRYPTO_METRIC_TIMER(decrypt); // Time the decryption
+    CRYPTO_METRIC_COUNT(bytes_decrypted, max_plaintext_size()); // Count every byte slot
+
+    Workspace& workspace = Workspace::thread_local_instance(); // Scratch for the product
+    Workspace::Scope scope(workspace, Workspace::Release::wipe); // c2 - c1 * s is the message
+    int32_t* c1_ntt = workspace.take(N); // Copy of c1 to transform in place
+    std::copy(c1.begin(), c1.end(), c1_ntt); // Copy c1
+    forward(c1_ntt); // Forward transform of c1
+    int32_t* c1_s = workspace.take(N); // c1 * s
+    multiply_by_key(secret_key, c1_ntt, c1_s); // One pointwise product and one inverse transform
+
+    for (int i = 0; i + 1 < N; i += 2) { // Loop through each coefficient pair
+        int low = c2[i] - c1_s[i]; // m + noise = c2 - c1 * s, low nibble
+        int high = c2[i + 1] - c1_s[i + 1]; // m + noise = c2 - c1 * s, high nibble
+        if (low < 0) low += q; // Bring into [0, q)
+        if (high < 0) high += q; // Bring into [0, q)
+        low = ((low * kNibbleLevels + q / 2) / q) % kNibbleLevels; // Round to the nearest nibble
+        high = ((high * kNibbleLevels + q / 2) / q) % kNibbleLevels; // Round to the nearest nibble
+        out[i / 2] = static_cast<uint8_t>(low | (high << 4)); // Store the decrypted byte
+    }
+}
+
+template <class P>
+std::string RingLWE<P>::decrypt_bytes(const Ciphertext& ciphertext) { // Function to decrypt ciphertext to raw bytes
+    std::string plaintext; // Decrypted bytes
+    decrypt_into(ciphertext, plaintext); // Decrypt
+    return plaintext; // Return the decrypted bytes
+}
+
+template <class P>
+void RingLWE<P>::decrypt_into(const Ciphertext& ciphertext, std::string& out) { // Function to decrypt into reused storage
+    CRYPTO_LOG(trace) << "Starting decryption..."; // Log the start of decryption
+    out.resize(max_plaintext_size()); // Every byte slot; no allocation once out has the capacity
+    decrypt_raw(ciphertext, reinterpret_cast<uint8_t*>(&out[0])); // Decrypt all of them
+
+    size_t length = 0; // Bytes before the padding
+    while (length < out.size() && out[length] != '\0' && out[length] != '\xff') ++length; // Stop at the first padding byte
+    if (length < out.size()) { // Check if padding was found
+        CRYPTO_LOG(trace) << "Padding found and stripped from the decrypted message."; // Log the padding
+    }
+    out.resize(length); // Strip the padding, keeping the capacity
+
+    CRYPTO_LOG(trace) << "Decrypted " << out.size() << " bytes"; // Log the size, never the plaintext
+}
+
+template <class P>
+std::string RingLWE<P>::decrypt(const Ciphertext& ciphertext) { // Function to decrypt ciphertext to hex
+    static const char digits[] = "0123456789abcdef"; // Lowercase hex digits
+    std::string plaintext = decrypt_bytes(ciphertext); // Raw bytes
+    std::string hex(plaintext.size() * 2, '0'); // Two digits per byte
+    for (size_t i = 0; i < plaintext.size(); ++i) { // Loop through each byte
+        unsigned char byte = static_cast<unsigned char>(plaintext[i]); // Byte to format
+        hex[2 * i] = digits[byte >> 4]; // High digit
+        hex[2 * i + 1] = digits[byte & 0x0f]; // Low digit
+    }
+    return hex; // Return the decrypted hex string
+}
+
+template class RingLWE<Params256>; // Explicit instantiation for N = 256
+template class RingLWE<Params512>; // Explicit instantiation for N = 512
+template class RingLWE<Params1024>; // Explicit instantiation for N = 1024
+
+namespace { // Helpers local to this translation unit
+
+[[noreturn]] void throw_unsupported(int poly_degree, int modulus) { // Function to reject unknown parameters
+    CRYPTO_LOG(error) << "Unsupported parameters n: " << poly_degree << ", q: " << modulus; // Log the error
+    throw std::invalid_argument("Unsupported Ring-LWE parameters (" + std::to_string(poly_degree) + ", " + std::to_string(modulus) +
+                                "); supported: (256, 7681), (512, 12289), (1024, 12289)"); // Throw invalid argument
+}
+
+} // End of anonymous namespace
+
+std::unique_ptr<RingLWEEngine> make_engine(int poly_degree, int modulus, const NttKernels& kernels) { // Function to dispatch on runtime parameters
+    if (poly_degree == Params256::N && modulus == Params256::q) return std::unique_ptr<RingLWEEngine>(new RingLWE<Params256>(kernels)); // N = 256
+    if (poly_degree == Params512::N && modulus == Params512::q) return std::unique_ptr<RingLWEEngine>(new RingLWE<Params512>(kernels)); // N = 512
+    if (poly_degree == Params1024::N && modulus == Params1024::q) return std::unique_ptr<RingLWEEngine>(new RingLWE<Params1024>(kernels)); // N = 1024
+    throw_unsupported(poly_degree, modulus); // No parameter set matches
+}
+
+std::unique_ptr<RingLWEEngine> make_engine(int poly_degree, int modulus, RingKey secret, std::pair<RingKey, RingKey> public_keys) { // Function to dispatch over existing keys
+    if (poly_degree == Params256::N && modulus == Params256::q) return std::unique_ptr<RingLWEEngine>(new RingLWE<Params256>(std::move(secret), std::move(public_keys))); // N = 256
+    if (poly_degree == Params512::N && modulus == Params512::q) return std::unique_ptr<RingLWEEngine>(new RingLWE<Params512>(std::move(secret), std::move(public_keys))); // N = 512
+    if (poly_degree == Params1024::N && modulus == Params1024::q) return std::unique_ptr<RingLWEEngine>(new RingLWE<Params1024>(std::move(secret), std::move(public_keys))); // N = 1024
+    throw_unsupported(poly_degree, modulus); // No parameter set matches
+}
+
+}  // namespace lattice_crypto
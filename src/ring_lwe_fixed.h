@@ -0,0 +1,66 @@
+#ifndef RING_LWE_FIXED_H
+#define RING_LWE_FIXED_H
+
+#include <cstdint>
+#include <utility>
+#include "param_sets.h"
+
+namespace lattice_crypto {
+
+// Scalar transforms specialized on a compile-time parameter set. RingLWE<P> runs these when the CPU has no SIMD
+// kernels; they must stay bit-identical to NttPlan over NttTables<P>::view(), which test_ntt_kernels checks.
+
+// Product of two coefficients in [0, q); q is a compile-time constant, so % needs no division instruction
+template <class P>
+inline int32_t fixed_mul_mod(int32_t a, int32_t b) {
+    return static_cast<int32_t>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b) % static_cast<uint32_t>(P::q));
+}
+
+// Bit-reversed cyclic transform over the compile-time tables of P
+template <class P>
+void fixed_transform(int32_t* a, const int32_t* twiddles) {
+    using Tables = NttTables<P>;
+    constexpr int N = P::N;
+    constexpr int32_t q = P::q;
+    for (int i = 0; i < N; ++i) {
+        int j = Tables::bit_reversal[i];
+        if (i < j) std::swap(a[i], a[j]);
+    }
+    for (int half = 1; half < N; half <<= 1) {
+        const int32_t* w = twiddles + half - 1;
+        for (int i = 0; i < N; i += 2 * half) {
+            for (int j = 0; j < half; ++j) {
+                int32_t u = a[i + j];
+                int32_t v = fixed_mul_mod<P>(a[i + j + half], w[j]);
+                int32_t sum = u + v;
+                int32_t diff = u - v;
+                a[i + j] = sum >= q ? sum - q : sum;
+                a[i + j + half] = diff < 0 ? diff + q : diff;
+            }
+        }
+    }
+}
+
+// In-place forward negacyclic transform of P::N coefficients in [0, q)
+template <class P>
+void fixed_forward(int32_t* a) {
+    for (int i = 0; i < P::N; ++i) a[i] = fixed_mul_mod<P>(a[i], NttTables<P>::twist[i]);  // Twist by psi^i
+    fixed_transform<P>(a, NttTables<P>::forward_twiddles.data());
+}
+
+// In-place inverse negacyclic transform, including the scaling by n^-1
+template <class P>
+void fixed_inverse(int32_t* a) {
+    fixed_transform<P>(a, NttTables<P>::inverse_twiddles.data());
+    for (int i = 0; i < P::N; ++i) a[i] = fixed_mul_mod<P>(a[i], NttTables<P>::untwist[i]);  // Untwist and scale by n^-1
+}
+
+// Coefficient-wise product of two transformed polynomials
+template <class P>
+void fixed_pointwise(const int32_t* a, const int32_t* b, int32_t* out) {
+    for (int i = 0; i < P::N; ++i) out[i] = fixed_mul_mod<P>(a[i], b[i]);
+}
+
+}  // namespace lattice_crypto
+
+#endif  // RING_LWE_FIXED_H
@@ -0,0 +1,162 @@
+#include "sampler.h"  // Include the header file for declarations
+#include "metrics.h"  // Counters and latency histograms
+#include <openssl/crypto.h>  // For OPENSSL_cleanse
+#include <openssl/evp.h>  // For the AES-256-CTR keystream
+#include <openssl/rand.h>  // For RAND_bytes
+#include <algorithm>  // For std::min
+#include <cstring>  // For std::memcpy and std::memset
+#include <stdexcept>  // For std::runtime_error and std::invalid_argument
+#include <string>  // For std::to_string
+#include <atomic>  // For the fork generation
+#include <pthread.h>  // For pthread_atfork
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+// Number of set bits in x
+inline int popcount32(uint32_t x) { // Bit count of one field
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(x); // POPCNT where the target has it
+#else
+    x = x - ((x >> 1) & 0x55555555u); // Two-bit partial counts
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u); // Four-bit partial counts
+    x = (x + (x >> 4)) & 0x0f0f0f0fu; // Byte counts
+    return static_cast<int>((x * 0x01010101u) >> 24); // Sum the bytes
+#endif
+}
+
+std::atomic<uint64_t> fork_generation{0}; // Forks seen by this process and its ancestors
+
+extern "C" void bump_fork_generation() { // Child-side fork handler
+    fork_generation.fetch_add(1, std::memory_order_relaxed); // Only the forking thread runs in the child
+}
+
+// Current fork generation; the first call installs the handler, before any sampler holds bytes
+uint64_t current_generation() { // Function to read the fork count
+    static const bool registered = (pthread_atfork(nullptr, nullptr, bump_fork_generation), true); // Once per process image
+    (void)registered; // Only the side effect matters
+    return fork_generation.load(std::memory_order_relaxed); // Return the count
+}
+
+} // End of anonymous namespace
+
+Sampler::Sampler() // Constructor over the system generator
+    : src(SamplerSource::system), cipher(nullptr), offset(kBlockBytes), generation(current_generation()) {} // Empty until first use
+
+Sampler::Sampler(const std::array<uint8_t, 32>& seed) // Constructor over a seeded keystream
+    : src(SamplerSource::aes_ctr), cipher(EVP_CIPHER_CTX_new()), offset(kBlockBytes), generation(current_generation()) { // Empty until first use
+    if (cipher == nullptr) { // Check the allocation
+        throw std::runtime_error("Failed to allocate the AES-CTR context."); // Throw runtime error
+    }
+    const unsigned char iv[16] = {0}; // Counter starts at zero; the seed is the key
+    if (EVP_EncryptInit_ex(cipher, EVP_aes_256_ctr(), nullptr, seed.data(), iv) != 1) { // Key the keystream
+        EVP_CIPHER_CTX_free(cipher); // Release the context
+        throw std::runtime_error("Failed to initialize the AES-CTR keystream."); // Throw runtime error
+    }
+}
+
+Sampler::~Sampler() { // Destructor
+    OPENSSL_cleanse(block.data(), block.size()); // Do not leave randomness behind
+    if (cipher != nullptr) EVP_CIPHER_CTX_free(cipher); // Release the keystream
+}
+
+void Sampler::refill() { // Function to fetch the next block
+    if (src == SamplerSource::system) { // System generator
+        if (RAND_bytes(block.data(), static_cast<int>(block.size())) != 1) { // One call per block
+            throw std::runtime_error("Error generating secure random bytes."); // Throw runtime error
+        }
+    } else { // Seeded keystream: encrypt zeros to get the raw keystream
+        std::memset(block.data(), 0, block.size()); // Zero plaintext
+        int written = 0; // Bytes produced
+        if (EVP_EncryptUpdate(cipher, block.data(), &written, block.data(), static_cast<int>(block.size())) != 1 ||
+            written != static_cast<int>(block.size())) { // Encrypt in place
+            throw std::runtime_error("Error generating the AES-CTR keystream."); // Throw runtime error
+        }
+    }
+    offset = 0; // Start reading from the top
+}
+
+uint64_t Sampler::next_word() { // Function to read 64 random bits
+    if (offset + sizeof(uint64_t) > block.size()) refill(); // Fetch a new block when this one is used up
+    uint64_t word; // Result
+    std::memcpy(&word, block.data() + offset, sizeof(word)); // Unaligned-safe read
+    OPENSSL_cleanse(block.data() + offset, sizeof(word)); // Secret polynomials are drawn here; their bits must not linger in the block
+    offset += sizeof(word); // Advance
+    return word; // Return the bits
+}
+
+void Sampler::fill_bytes(uint8_t* out, size_t count) { // Function to copy random bytes
+    while (count > 0) { // Until the request is served
+        if (offset == block.size()) refill(); // Fetch a new block when this one is used up
+        size_t take = std::min(count, block.size() - offset); // Bytes available now
+        std::memcpy(out, block.data() + offset, take); // Copy them out
+        OPENSSL_cleanse(block.data() + offset, take); // Keys drawn here must not linger in the block
+        offset += take; // Advance
+        out += take; // Advance
+        count -= take; // Remaining
+    }
+}
+
+void Sampler::fill_binary(int32_t* out, size_t count) { // Function to sample {0, 1} coefficients
+    CRYPTO_METRIC_TIMER(sampling); // Time the fill
+    CRYPTO_METRIC_COUNT(sampled_coefficients, count); // Count the coefficients
+    for (size_t i = 0; i < count; i += 64) { // 64 coefficients per word
+        uint64_t word = next_word(); // Random bits
+        size_t take = std::min<size_t>(64, count - i); // Coefficients in this word
+        for (size_t j = 0; j < take; ++j) { // Loop through each bit
+            out[i + j] = static_cast<int32_t>((word >> j) & 1); // One bit per coefficient
+        }
+    }
+}
+
+void Sampler::fill_uniform(int32_t* out, size_t count, int q) { // Function to sample uniform coefficients
+    if (q < 2 || q > 65536) { // Candidates are 16 bits wide
+        throw std::invalid_argument("Modulus " + std::to_string(q) + " must be in [2, 65536]"); // Throw invalid argument
+    }
+    CRYPTO_METRIC_TIMER(sampling); // Time the fill
+    CRYPTO_METRIC_COUNT(sampled_coefficients, count); // Count the coefficients
+    const uint32_t limit = (65536u / q) * q; // Largest multiple of q not above 2^16, for rejection sampling
+    size_t i = 0; // Next coefficient
+    while (i < count) { // Until every coefficient is accepted
+        uint64_t word = next_word(); // Four 16-bit candidates
+        for (int k = 0; k < 4 && i < count; ++k) { // Loop through each candidate
+            uint32_t value = static_cast<uint32_t>(word & 0xffff); // 16-bit candidate
+            word >>= 16; // Next candidate
+            if (value < limit) out[i++] = static_cast<int32_t>(value % q); // Keep unbiased candidates
+        }
+    }
+}
+
+void Sampler::fill_centered_binomial(int32_t* out, size_t count, int eta) { // Function to sample centered binomial errors
+    if (eta < 1 || eta > 16) { // Both halves must fit in a 32-bit field
+        throw std::invalid_argument("eta " + std::to_string(eta) + " must be in [1, 16]"); // Throw invalid argument
+    }
+    CRYPTO_METRIC_TIMER(sampling); // Time the fill
+    CRYPTO_METRIC_COUNT(sampled_coefficients, count); // Count the coefficients
+    const int per_word = 64 / (2 * eta); // Coefficients drawn from one 64-bit word
+    const uint32_t mask = (eta == 16) ? 0xffffu : ((1u << eta) - 1); // Low eta bits
+    size_t i = 0; // Next coefficient
+    while (i < count) { // Until every coefficient is drawn
+        uint64_t word = next_word(); // Random bits
+        for (int k = 0; k < per_word && i < count; ++k, ++i) { // Loop through each field
+            uint32_t a = static_cast<uint32_t>(word) & mask; // First eta bits
+            uint32_t b = static_cast<uint32_t>(word >> eta) & mask; // Next eta bits
+            word >>= 2 * eta; // Next field
+            out[i] = popcount32(a) - popcount32(b); // Difference of two binomial(eta, 0.5) draws
+        }
+    }
+}
+
+Sampler& Sampler::thread_local_instance() { // Function to get this thread's sampler
+    thread_local Sampler instance; // One buffer per thread, no locking
+    const uint64_t generation = current_generation(); // Forks so far
+    if (instance.generation != generation) { // Forked since the last draw
+        OPENSSL_cleanse(instance.block.data(), instance.block.size()); // Drop the parent's bytes
+        instance.offset = instance.block.size(); // Force a refill
+        instance.generation = generation; // Adopt the child
+    }
+    return instance; // Return the sampler
+}
+
+}  // namespace lattice_crypto
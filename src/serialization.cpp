@@ -0,0 +1,190 @@
+#include "serialization.h"  // Include the header file for declarations
+#include <stdexcept>  // For std::invalid_argument
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+const char kMagic[4] = {'C', 'R', 'L', 'W'}; // First four bytes of every blob
+
+// Little-endian stores and loads; compilers turn these into single moves on little-endian targets
+inline void store_le32(uint8_t* out, uint32_t value) { // Store 32 bits
+    out[0] = static_cast<uint8_t>(value); // Byte 0
+    out[1] = static_cast<uint8_t>(value >> 8); // Byte 1
+    out[2] = static_cast<uint8_t>(value >> 16); // Byte 2
+    out[3] = static_cast<uint8_t>(value >> 24); // Byte 3
+}
+
+inline uint32_t load_le32(const uint8_t* in) { // Load 32 bits
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24); // Assemble the word
+}
+
+// Checks everything about a blob except the coefficient values and returns its header
+BlobHeader parse_header(std::string_view data, BlobType expected) { // Function to validate a blob header
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data()); // Read cursor
+    if (data.size() < kSerializedHeaderBytes) { // Check the header is there
+        throw std::invalid_argument("Serialized data is shorter than its header."); // Throw invalid argument
+    }
+    for (int i = 0; i < 4; ++i) { // Check the magic
+        if (p[i] != static_cast<uint8_t>(kMagic[i])) throw std::invalid_argument("Serialized data has a bad magic number."); // Throw invalid argument
+    }
+    if (p[4] != kSerializationVersion) { // Check the version
+        throw std::invalid_argument("Unsupported serialization version " + std::to_string(p[4]) + "."); // Throw invalid argument
+    }
+    if (p[5] != static_cast<uint8_t>(expected)) { // Check the type
+        throw std::invalid_argument("Serialized data holds a different kind of object."); // Throw invalid argument
+    }
+
+    BlobHeader parsed; // Header fields
+    parsed.type = expected; // Blob type
+    parsed.bits = p[6]; // Coefficient width
+    parsed.polynomials = p[7]; // Polynomial count
+    parsed.n = static_cast<int>(load_le32(p + 8)); // Ring degree
+    parsed.q = static_cast<int>(load_le32(p + 12)); // Modulus
+    if (parsed.q < 2 || parsed.q > 65536 || parsed.bits != coefficient_bits(parsed.q) || parsed.n <= 0 || parsed.n > (1 << 16)) { // Check the shape
+        throw std::invalid_argument("Serialized data has an invalid header."); // Throw invalid argument
+    }
+    if (data.size() != serialized_size(static_cast<size_t>(parsed.n), parsed.q, parsed.polynomials)) { // Check the length exactly
+        throw std::invalid_argument("Serialized data has the wrong length."); // Throw invalid argument
+    }
+    return parsed; // Return the header
+}
+
+// Unpacks one body and checks its coefficients against q
+void unpack_checked(const uint8_t* in, const BlobHeader& header, int32_t* out) { // Function to unpack a validated body
+    unpack_coefficients(in, static_cast<size_t>(header.n), header.bits, out); // Unpack in place
+    for (int i = 0; i < header.n; ++i) { // Loop through each coefficient
+        if (out[i] >= header.q) throw std::invalid_argument("Serialized coefficient out of range [0, q)."); // Throw invalid argument
+    }
+}
+
+} // End of anonymous namespace
+
+int coefficient_bits(int q) { // Function to size a coefficient
+    if (q < 2 || q > 65536) { // Coefficients are packed in at most 16 bits
+        throw std::invalid_argument("Modulus " + std::to_string(q) + " must be in [2, 65536]"); // Throw invalid argument
+    }
+    int bits = 0; // Width so far
+    while ((1 << bits) < q) ++bits; // Smallest width holding q - 1
+    return bits; // Return the width
+}
+
+size_t packed_size(size_t n, int bits) { // Function to size a packed polynomial
+    return (n * static_cast<size_t>(bits) + 7) / 8; // Round up to whole bytes
+}
+
+// Coefficients are shifted into a 64-bit accumulator and written out 32 bits at a time: with at most 16 bits
+// per coefficient and fewer than 32 bits pending, the accumulator never overflows
+void pack_coefficients(const int32_t* in, size_t n, int bits, uint8_t* out) { // Function to pack coefficients
+    uint64_t acc = 0; // Pending bits, LSB first
+    int pending = 0; // Number of pending bits
+    for (size_t i = 0; i < n; ++i) { // Loop through each coefficient
+        acc |= static_cast<uint64_t>(static_cast<uint32_t>(in[i])) << pending; // Append the coefficient
+        pending += bits; // Count its bits
+        if (pending >= 32) { // A full word is ready
+            store_le32(out, static_cast<uint32_t>(acc)); // Write it
+            out += 4; // Advance
+            acc >>= 32; // Drop the written bits
+            pending -= 32; // Count them
+        }
+    }
+    while (pending > 0) { // Flush the tail a byte at a time
+        *out++ = static_cast<uint8_t>(acc); // Write one byte
+        acc >>= 8; // Drop it
+        pending -= 8; // Count it
+    }
+}
+
+// The inverse: refill the accumulator 32 bits at a time and peel coefficients off the bottom
+void unpack_coefficients(const uint8_t* in, size_t n, int bits, int32_t* out) { // Function to unpack coefficients
+    const uint8_t* end = in + packed_size(n, bits); // Never read past the packed bytes
+    const uint64_t mask = (uint64_t(1) << bits) - 1; // Low 'bits' bits
+    uint64_t acc = 0; // Unread bits, LSB first
+    int available = 0; // Number of unread bits
+    for (size_t i = 0; i < n; ++i) { // Loop through each coefficient
+        if (available < bits) { // Not enough bits buffered
+            if (end - in >= 4) { // Whole word available
+                acc |= static_cast<uint64_t>(load_le32(in)) << available; // Append 32 bits
+                in += 4; // Advance
+                available += 32; // Count them
+            } else { // Tail: byte by byte
+                while (available < bits && in < end) { // Until the coefficient is complete
+                    acc |= static_cast<uint64_t>(*in++) << available; // Append 8 bits
+                    available += 8; // Count them
+                }
+            }
+        }
+        out[i] = static_cast<int32_t>(acc & mask); // Low bits are the coefficient
+        acc >>= bits; // Drop them
+        available -= bits; // Count them
+    }
+}
+
+size_t serialized_size(size_t n, int q, int count) { // Function to size a blob
+    return kSerializedHeaderBytes + static_cast<size_t>(count) * packed_size(n, coefficient_bits(q)); // Header and bodies
+}
+
+void serialize_polynomials_into(BlobType type, int q, size_t n, const int32_t* const* polynomials, int count, uint8_t* out) { // Function to serialize in place
+    const int bits = coefficient_bits(q); // Width of each coefficient
+    const size_t body = packed_size(n, bits); // Bytes per polynomial
+    for (int i = 0; i < 4; ++i) out[i] = static_cast<uint8_t>(kMagic[i]); // Magic
+    out[4] = kSerializationVersion; // Version
+    out[5] = static_cast<uint8_t>(type); // Blob type
+    out[6] = static_cast<uint8_t>(bits); // Coefficient width
+    out[7] = static_cast<uint8_t>(count); // Polynomial count
+    store_le32(out + 8, static_cast<uint32_t>(n)); // Ring degree
+    store_le32(out + 12, static_cast<uint32_t>(q)); // Modulus
+    out += kSerializedHeaderBytes; // Start of the bodies
+
+    for (int k = 0; k < count; ++k) { // Loop through each polynomial
+        const int32_t* polynomial = polynomials[k]; // Coefficients to pack
+        for (size_t i = 0; i < n; ++i) { // Loop through each coefficient
+            if (polynomial[i] < 0 || polynomial[i] >= q) { // Packing assumes reduced coefficients
+                throw std::invalid_argument("Coefficient out of range [0, q) during serialization."); // Throw invalid argument
+            }
+        }
+        pack_coefficients(polynomial, n, bits, out); // Pack in place
+        out += body; // Next polynomial
+    }
+}
+
+std::string serialize_polynomials(BlobType type, int q, size_t n, const std::vector<const int32_t*>& polynomials) { // Function to serialize a blob
+    const int count = static_cast<int>(polynomials.size()); // Number of polynomials
+    std::string out(serialized_size(n, q, count), '\0'); // Whole blob, written in place
+    serialize_polynomials_into(type, q, n, polynomials.data(), count, reinterpret_cast<uint8_t*>(&out[0])); // Fill it
+    return out; // Return the blob
+}
+
+std::vector<RingElement> deserialize_polynomials(std::string_view data, BlobType expected, BlobHeader* header) { // Function to parse a blob
+    const BlobHeader parsed = parse_header(data, expected); // Validated header
+    const size_t body = packed_size(static_cast<size_t>(parsed.n), parsed.bits); // Bytes per polynomial
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data()) + kSerializedHeaderBytes; // Start of the bodies
+
+    std::vector<RingElement> polynomials; // Parsed polynomials
+    polynomials.reserve(parsed.polynomials); // One per body
+    for (int k = 0; k < parsed.polynomials; ++k) { // Loop through each polynomial
+        RingElement polynomial(static_cast<size_t>(parsed.n)); // Destination
+        unpack_checked(p, parsed, polynomial.data()); // Unpack in place
+        polynomials.push_back(std::move(polynomial)); // Keep it
+        p += body; // Next polynomial
+    }
+    if (header != nullptr) *header = parsed; // Report the header
+    return polynomials; // Return the polynomials
+}
+
+void deserialize_polynomials_into(std::string_view data, BlobType expected, size_t n, int q, RingElement* const* out, int count) { // Function to parse into existing elements
+    const BlobHeader parsed = parse_header(data, expected); // Validated header
+    if (static_cast<size_t>(parsed.n) != n || parsed.q != q || parsed.polynomials != count) { // Check it is the expected shape
+        throw std::invalid_argument("Serialized data was made for other parameters."); // Throw invalid argument
+    }
+    const size_t body = packed_size(n, parsed.bits); // Bytes per polynomial
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data()) + kSerializedHeaderBytes; // Start of the bodies
+    for (int k = 0; k < count; ++k) { // Loop through each polynomial
+        if (out[k]->size() != n) throw std::invalid_argument("Destination does not match the polynomial degree."); // Check the destination
+        unpack_checked(p, parsed, out[k]->data()); // Unpack in place
+        p += body; // Next polynomial
+    }
+}
+
+}  // namespace lattice_crypto
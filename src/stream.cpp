@@ -0,0 +1,163 @@
+#include "stream.h"  // Include the header file for declarations
+#include "lattice_crypto.h"  // For RingLWECrypto
+#include "serialization.h"  // Bit-packed ciphertext format
+#include "thread_pool.h"  // Work-stealing pool for the block batches
+#include "crypto_log.h"  // Leveled asynchronous logging
+#include "sampler.h"  // Random stream nonce
+#include <algorithm>  // For std::min
+#include <cstring>  // For std::memcpy
+#include <stdexcept>  // For std::invalid_argument, std::length_error and std::logic_error
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+constexpr size_t kFrameBytes = kStreamFrameBytes; // Frame at the start of every block
+constexpr unsigned kFinalFlag = 0x8000; // Frame bit marking the final block
+constexpr unsigned kLengthMask = 0x7fff; // Frame bits holding the payload length
+constexpr uint64_t kMaxBlocks = uint64_t(1) << 32; // Block indices are 32 bits wide
+
+void store_u32(char* out, uint32_t value) { // Function to write a little-endian word
+    for (int i = 0; i < 4; ++i) out[i] = static_cast<char>(value >> (8 * i)); // Low byte first
+}
+
+uint32_t load_u32(const unsigned char* in) { // Function to read a little-endian word
+    return uint32_t(in[0]) | uint32_t(in[1]) << 8 | uint32_t(in[2]) << 16 | uint32_t(in[3]) << 24; // Low byte first
+}
+
+} // End of anonymous namespace
+
+EncryptStream::EncryptStream(RingLWECrypto& crypto, size_t batch_blocks) // Constructor sizing the buffers once
+    : engine(crypto.engine()), // Engine of the parameter set
+      capacity(engine.max_plaintext_size()), // Plaintext bytes per ciphertext
+      payload(capacity - kFrameBytes), // Room left after the frame word
+      block_bytes(serialized_size(engine.degree(), engine.modulus(), 2)), // (c1, c2) per block
+      batch_blocks(batch_blocks == 0 ? 1 : batch_blocks), // At least one block per batch
+      ciphertexts(this->batch_blocks), // One slot per block of a batch
+      nonce(0), // Drawn below
+      next_block(0), // Blocks count from zero
+      finished(false) { // Open for updates
+    uint8_t bytes[4]; // Raw nonce
+    Sampler::thread_local_instance().fill_bytes(bytes, sizeof(bytes)); // Fresh per stream
+    nonce = load_u32(bytes); // Same in every block
+    pending.reserve(this->batch_blocks * payload); // Never grows past one batch
+    framed.assign(this->batch_blocks * capacity, '\0'); // One framed plaintext per block
+}
+
+void EncryptStream::update(std::string_view plaintext, std::string& out) { // Function to take a plaintext chunk
+    if (finished) throw std::logic_error("Stream has already been finalized."); // Throw logic error
+    const size_t batch_bytes = batch_blocks * payload; // Plaintext per batch
+    while (!plaintext.empty()) { // Loop until the chunk is consumed
+        size_t take = std::min(plaintext.size(), batch_bytes - pending.size()); // Fill up the batch
+        pending.append(plaintext.data(), take); // Buffer it
+        plaintext.remove_prefix(take); // Advance
+        if (pending.size() == batch_bytes) encrypt_pending(false, out); // Encrypt a full batch
+    }
+}
+
+void EncryptStream::finalize(std::string& out) { // Function to end the stream
+    if (finished) throw std::logic_error("Stream has already been finalized."); // Throw logic error
+    encrypt_pending(true, out); // The last block carries the final flag, even when it is empty
+    finished = true; // No more updates
+}
+
+void EncryptStream::encrypt_pending(bool final, std::string& out) { // Function to encrypt the buffered plaintext
+    size_t blocks = (pending.size() + payload - 1) / payload; // Blocks needed
+    if (final && blocks == 0) blocks = 1; // An empty final block ends the stream
+    if (blocks == 0) return; // Nothing to do
+    if (next_block + blocks > kMaxBlocks) throw std::length_error("Stream exceeds 2^32 blocks."); // Throw length error
+    const size_t offset = out.size(); // Where this batch starts
+    out.resize(offset + blocks * block_bytes); // Room for every block, written in place
+    uint8_t* destination = reinterpret_cast<uint8_t*>(&out[offset]); // Start of this batch
+    const int n = engine.degree(); // Ring degree
+    const int q = engine.modulus(); // Modulus
+
+    ThreadPool::shared().parallel_for(blocks, [&](size_t i) { // Blocks of a batch run concurrently
+        const size_t start = i * payload; // First plaintext byte of the block
+        const size_t length = std::min(payload, pending.size() - start); // Payload bytes in the block
+        const unsigned frame = static_cast<unsigned>(length) | (final && i + 1 == blocks ? kFinalFlag : 0); // Frame word
+        char* block = &framed[i * capacity]; // Framed plaintext of the block
+        block[0] = static_cast<char>(frame & 0xff); // Low byte
+        block[1] = static_cast<char>(frame >> 8); // High byte
+        store_u32(block + 2, static_cast<uint32_t>(next_block + i)); // Position in the stream
+        store_u32(block + 6, nonce); // Ties the block to this stream
+        std::memcpy(block + kFrameBytes, pending.data() + start, length); // Payload
+        engine.encrypt_into(std::string_view(block, kFrameBytes + length), ciphertexts[i]); // Encrypt the block into reused storage
+        const int32_t* parts[2] = {ciphertexts[i].first.data(), ciphertexts[i].second.data()}; // (c1, c2)
+        serialize_polynomials_into(BlobType::ciphertext, q, n, parts, 2, destination + i * block_bytes); // Pack in place
+    });
+    next_block += blocks; // The next batch continues the count
+    CRYPTO_LOG(trace) << "Encrypted stream batch of " << blocks << " blocks"; // Log the batch, never the plaintext
+    pending.clear(); // Keeps its capacity
+}
+
+DecryptStream::DecryptStream(RingLWECrypto& crypto, size_t batch_blocks) // Constructor sizing the buffers once
+    : engine(crypto.engine()), // Engine of the parameter set
+      capacity(engine.max_plaintext_size()), // Plaintext bytes per ciphertext
+      payload(capacity - kFrameBytes), // Room left after the frame word
+      block_bytes(serialized_size(engine.degree(), engine.modulus(), 2)), // (c1, c2) per block
+      batch_blocks(batch_blocks == 0 ? 1 : batch_blocks), // At least one block per batch
+      nonce(0), // Taken from the first block
+      next_block(0), // Blocks count from zero
+      finished(false) { // Waiting for the final block
+    pending.reserve(this->batch_blocks * block_bytes); // Never grows past one batch
+    slots.assign(this->batch_blocks * capacity, '\0'); // One decrypted plaintext per block
+    ciphertexts.reserve(this->batch_blocks); // One slot per block of a batch
+    for (size_t i = 0; i < this->batch_blocks; ++i) { // Allocate the parse targets once
+        ciphertexts.emplace_back(RingElement(engine.degree()), RingElement(engine.degree())); // (c1, c2)
+    }
+}
+
+void DecryptStream::update(std::string_view ciphertext, std::string& out) { // Function to take a ciphertext chunk
+    const size_t batch_bytes = batch_blocks * block_bytes; // Ciphertext per batch
+    while (!ciphertext.empty()) { // Loop until the chunk is consumed
+        if (finished) throw std::invalid_argument("Data after the final block of the stream."); // Throw invalid argument
+        size_t take = std::min(ciphertext.size(), batch_bytes - pending.size()); // Fill up the batch
+        pending.append(ciphertext.data(), take); // Buffer it
+        ciphertext.remove_prefix(take); // Advance
+        if (pending.size() == batch_bytes) decrypt_pending(out); // Decrypt a full batch
+    }
+}
+
+void DecryptStream::finalize(std::string& out) { // Function to end the stream
+    if (pending.size() % block_bytes != 0) { // A block was cut short
+        throw std::invalid_argument("Stream ends inside a block."); // Throw invalid argument
+    }
+    decrypt_pending(out); // Whatever whole blocks are left
+    if (!finished) throw std::invalid_argument("Stream ends before its final block."); // Throw invalid argument
+}
+
+void DecryptStream::decrypt_pending(std::string& out) { // Function to decrypt the buffered blocks
+    const size_t blocks = pending.size() / block_bytes; // Whole blocks buffered
+    if (blocks == 0) return; // Nothing to do
+    const int n = engine.degree(); // Ring degree
+    const int q = engine.modulus(); // Modulus
+
+    ThreadPool::shared().parallel_for(blocks, [&](size_t i) { // Blocks of a batch run concurrently
+        RingElement* parts[2] = {&ciphertexts[i].first, &ciphertexts[i].second}; // Parse targets
+        deserialize_polynomials_into(std::string_view(pending.data() + i * block_bytes, block_bytes), BlobType::ciphertext, n, q, parts, 2); // Unpack in place
+        engine.decrypt_raw(ciphertexts[i], reinterpret_cast<uint8_t*>(&slots[i * capacity])); // Every byte slot of the block
+    });
+
+    for (size_t i = 0; i < blocks; ++i) { // Frames are checked in stream order
+        if (finished) throw std::invalid_argument("Data after the final block of the stream."); // Throw invalid argument
+        const unsigned char* block = reinterpret_cast<const unsigned char*>(&slots[i * capacity]); // Decrypted block
+        const unsigned frame = block[0] | (static_cast<unsigned>(block[1]) << 8); // Frame word
+        const size_t length = frame & kLengthMask; // Payload bytes in the block
+        const bool last = (frame & kFinalFlag) != 0; // Final block flag
+        if (length > payload || (!last && length != payload)) { // Only the final block may be short
+            throw std::invalid_argument("Stream block has an invalid frame."); // Throw invalid argument
+        }
+        if (next_block == 0) nonce = load_u32(block + 6); // The first block sets the stream nonce
+        if (next_block >= kMaxBlocks || load_u32(block + 2) != next_block || load_u32(block + 6) != nonce) { // Position and stream must match
+            throw std::invalid_argument("Stream block is out of sequence."); // Throw invalid argument
+        }
+        ++next_block; // The next block follows this one
+        out.append(reinterpret_cast<const char*>(block + kFrameBytes), length); // Payload
+        finished = last; // Nothing may follow the final block
+    }
+    CRYPTO_LOG(trace) << "Decrypted stream batch of " << blocks << " blocks"; // Log the batch, never the plaintext
+    pending.clear(); // Keeps its capacity
+}
+
+}  // namespace lattice_crypto
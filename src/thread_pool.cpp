@@ -0,0 +1,134 @@
+#include "thread_pool.h"  // Include the header file for declarations
+#include <algorithm>  // For std::min and std::max
+#include <exception>  // For std::exception_ptr
+#include <unistd.h>  // For getpid
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+thread_local bool inside_worker = false; // True on pool threads, where parallel_for runs inline
+
+// Completion state of one parallel_for call
+struct Batch { // Shared by the tasks of one call
+    std::mutex mutex; // Guards remaining and error
+    std::condition_variable done; // Signals the caller
+    size_t remaining = 0; // Tasks not yet finished
+    std::exception_ptr error; // First exception thrown by a task
+};
+
+} // End of anonymous namespace
+
+ThreadPool::ThreadPool(size_t count) : owner(getpid()) { // Constructor starting the workers
+    if (count == 0) count = std::max(1u, std::thread::hardware_concurrency()); // One worker per hardware thread
+    for (size_t i = 0; i < count; ++i) queues.emplace_back(new Queue()); // Queues first, so stealing never sees a missing one
+    threads.reserve(count); // One thread per queue
+    for (size_t i = 0; i < count; ++i) threads.emplace_back(&ThreadPool::run, this, i); // Start the workers
+}
+
+ThreadPool::~ThreadPool() { // Destructor joining the workers
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex); // Publish the stop flag
+        stopping = true; // Ask every worker to exit
+    }
+    wake.notify_all(); // Wake sleeping workers
+    for (std::thread& thread : threads) thread.join(); // Wait for them
+}
+
+ThreadPool& ThreadPool::shared() { // Function to get the process-wide pool
+    // Never destroyed, so batches running during static destruction still have their workers; no lock either,
+    // since a lock held by another thread at fork time would stay locked in the child
+    static std::atomic<ThreadPool*> instance{nullptr}; // Pool of the current process
+    ThreadPool* pool = instance.load(std::memory_order_acquire); // Current pool
+    if (pool != nullptr && pool->owner == getpid()) return *pool; // Started in this process
+    ThreadPool* fresh = new ThreadPool(); // First use, or first use since a fork
+    if (instance.compare_exchange_strong(pool, fresh, std::memory_order_acq_rel)) return *fresh; // The parent's pool, if any, is left behind
+    delete fresh; // Another thread of this process got there first
+    return *pool; // Use its pool
+}
+
+bool ThreadPool::next_task(size_t index, Task& task) { // Function to find work
+    for (size_t k = 0; k < queues.size(); ++k) { // Own queue first, then the others in turn
+        Queue& queue = *queues[(index + k) % queues.size()]; // Candidate queue
+        std::lock_guard<std::mutex> lock(queue.mutex); // Lock just this queue
+        if (queue.tasks.empty()) continue; // Nothing here
+        if (k == 0) { // Own queue: oldest first
+            task = std::move(queue.tasks.front()); // Take the front
+            queue.tasks.pop_front(); // Remove it
+        } else { // Someone else's queue: steal from the far end
+            task = std::move(queue.tasks.back()); // Take the back
+            queue.tasks.pop_back(); // Remove it
+        }
+        queued.fetch_sub(1); // One fewer task waiting
+        return true; // Found work
+    }
+    return false; // Every queue is empty
+}
+
+void ThreadPool::run(size_t index) { // Worker loop
+    inside_worker = true; // Nested parallel_for calls run inline
+    Task task; // Current task
+    while (true) { // Until stopped
+        if (next_task(index, task)) { // Work available
+            task(); // Run it
+            task = nullptr; // Release captured state
+            continue; // Look for more
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex); // Sleep until there is work
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; }); // Wait for work or shutdown
+        if (stopping) return; // Exit
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)>& body) { // Function to run a range
+    if (count == 0) return; // Nothing to do
+    if (inside_worker || threads.size() == 1 || count == 1 || owner != getpid()) { // No parallelism to gain, called from a worker, or forked away from the workers
+        std::exception_ptr error; // First exception, rethrown after the whole range like the parallel path
+        for (size_t i = 0; i < count; ++i) { // Run inline
+            try { // A failing index does not stop the others
+                body(i); // Run one index
+            } catch (...) { // Keep the first failure
+                if (!error) error = std::current_exception(); // Capture it
+            }
+        }
+        if (error) std::rethrow_exception(error); // Surface the first failure
+        return; // Done
+    }
+
+    // A few chunks per worker: large enough to amortize the queue, small enough to balance by stealing
+    const size_t chunks = std::min(count, threads.size() * 4); // Number of tasks
+    Batch batch; // Completion state
+    batch.remaining = chunks; // Every chunk must finish
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex); // Count before pushing, so the counter never runs below the queues
+        queued.fetch_add(chunks); // Tasks about to be queued
+    }
+    for (size_t c = 0; c < chunks; ++c) { // Split [0, count) into contiguous chunks
+        size_t begin = count * c / chunks; // First index of the chunk
+        size_t end = count * (c + 1) / chunks; // One past the last index
+        Task task = [&body, &batch, begin, end] { // Task running one chunk
+            std::exception_ptr error; // First exception from this chunk
+            for (size_t i = begin; i < end; ++i) { // Loop through each index
+                try { // A failing index does not stop the others
+                    body(i); // Run one index
+                } catch (...) { // Keep the first failure
+                    if (!error) error = std::current_exception(); // Capture it
+                }
+            }
+            std::lock_guard<std::mutex> lock(batch.mutex); // Report completion
+            if (error && !batch.error) batch.error = error; // Record the first failure
+            if (--batch.remaining == 0) batch.done.notify_one(); // Last chunk wakes the caller
+        };
+        Queue& queue = *queues[c % queues.size()]; // Round-robin over the workers
+        std::lock_guard<std::mutex> lock(queue.mutex); // Lock the target queue
+        queue.tasks.push_back(std::move(task)); // Queue the chunk
+    }
+    wake.notify_all(); // Wake the workers
+
+    std::unique_lock<std::mutex> lock(batch.mutex); // Wait for the whole range
+    batch.done.wait(lock, [&batch] { return batch.remaining == 0; }); // Until every chunk reported
+    if (batch.error) std::rethrow_exception(batch.error); // Surface the first failure
+}
+
+}  // namespace lattice_crypto
@@ -16,6 +16,31 @@ except ImportError:
 
 from encryption import Encrypt  # Assuming encryption is in the same src folder
 
+# Lattice keys live in a keystore file that is memory-mapped on load, so startup does no key generation and
+# pre-forked workers that import this module share the same read-only key pages
+LATTICE_KEYSTORE = os.environ.get(
+    'CREED_LATTICE_KEYSTORE', os.path.abspath(os.path.join(os.path.dirname(__file__), '../keys/lattice.keystore')))
+
+def load_lattice_crypto(path=LATTICE_KEYSTORE):
+    """Maps the wallet's lattice keys, generating and saving them on first use."""
+    if os.path.exists(path):
+        return RingLWECrypto.from_keystore(path)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    crypto = RingLWECrypto(512, 12289)
+    crypto.save_keystore(path)
+    logging.info(f"Generated lattice keystore at {path}")
+    return crypto
+
+# One key pair for the process, so ciphertexts written by encrypt_private_key can be read back by verify_lattice_encryption
+lattice_crypto = load_lattice_crypto()
+
+# Optional: keep this many encryptions precomputed on a background thread, so signing-time encryption only encodes
+# the message. Off by default; a pool does not carry over into forked workers, so pre-forking servers should enable
+# it in each worker instead.
+LATTICE_POOL_DEPTH = int(os.environ.get('CREED_LATTICE_POOL_DEPTH', '0'))
+if LATTICE_POOL_DEPTH > 0:
+    lattice_crypto.enable_randomness_pool(depth=LATTICE_POOL_DEPTH, refill_below=max(1, LATTICE_POOL_DEPTH // 2))
+
 def create_wallet():
     from variables import INFURA_ENDPOINT
     from web3 import Web3
@@ -45,16 +70,14 @@ def encrypt_private_key(acct):
     encrypted_private_key = Encrypt.encrypt_message(encryption_key, private_key_bytes)
     encrypted_private_key_b64 = base64.b64encode(encrypted_private_key).decode('utf-8')
     
-    lattice_crypt = RingLWECrypto(512, 4096)
-    encrypted_lattice = lattice_crypt.encrypt(encrypted_private_key)
-    encrypted_lattice_b64 = base64.b64encode(encrypted_lattice).decode('utf-8')
+    encrypted_lattice = lattice_crypto.encrypt(encrypted_private_key)
+    encrypted_lattice_b64 = base64.b64encode(lattice_crypto.to_bytes(encrypted_lattice)).decode('utf-8')
     
     return encrypted_private_key_b64, encrypted_lattice_b64
 
 def verify_lattice_encryption(encrypted_private_key_b64, encrypted_lattice_b64):
-    lattice_crypto = RingLWECrypto(512, 4096)
-    encrypted_lattice = base64.b64decode(encrypted_lattice_b64)
-    decrypted_lattice = lattice_crypto.decrypt(encrypted_lattice)
+    encrypted_lattice = lattice_crypto.from_bytes(base64.b64decode(encrypted_lattice_b64))
+    decrypted_lattice = lattice_crypto.decrypt_bytes(encrypted_lattice)
     decrypted_lattice_b64 = base64.b64encode(decrypted_lattice).decode('utf-8')
 
     if decrypted_lattice_b64 != encrypted_private_key_b64:
@@ -0,0 +1,55 @@
+#include "workspace.h"  // Include the header file for declarations
+#include <openssl/crypto.h>  // For OPENSSL_cleanse
+#include <algorithm>  // For std::max
+
+namespace lattice_crypto { // Start of lattice_crypto namespace
+
+namespace { // Helpers local to this translation unit
+
+constexpr size_t kAlignCoefficients = kCoefficientAlignment / sizeof(int32_t); // Coefficients per aligned line
+
+} // End of anonymous namespace
+
+Workspace::Scope::Scope(Workspace& workspace, Release release) // Constructor marking the arena
+    : workspace(workspace), chunk(workspace.current), used(workspace.used), release(release) {} // Remember the position
+
+Workspace::Scope::~Scope() { // Destructor releasing the scope
+    if (release == Release::wipe) { // Secrets were taken inside this scope
+        for (size_t c = chunk; c <= workspace.current && c < workspace.chunks.size(); ++c) { // Every chunk touched since the mark
+            const size_t begin = (c == chunk) ? used : 0; // Start at the mark in its own chunk
+            const size_t end = (c == workspace.current) ? workspace.used : workspace.chunks[c].size(); // Whole chunks in between
+            if (end > begin) OPENSSL_cleanse(workspace.chunks[c].data() + begin, (end - begin) * sizeof(int32_t)); // Wipe the range
+        }
+    }
+    workspace.current = chunk; // Back to the marked chunk
+    workspace.used = used; // And the marked position in it
+}
+
+int32_t* Workspace::take(size_t count) { // Function to carve out scratch
+    const size_t rounded = (count + kAlignCoefficients - 1) / kAlignCoefficients * kAlignCoefficients; // Keep the next buffer aligned
+    while (current < chunks.size()) { // Try the chunks already reserved
+        if (used + rounded <= chunks[current].size()) { // Fits in the current chunk
+            int32_t* buffer = chunks[current].data() + used; // Aligned, since every chunk and every size is
+            used += rounded; // Bump
+            return buffer; // Return the buffer
+        }
+        ++current; // Move on; earlier buffers stay where they are
+        used = 0; // Start of the next chunk
+    }
+    chunks.emplace_back(std::max(kChunkCoefficients, rounded)); // Grow; moving the vector keeps every chunk's storage in place
+    used = rounded; // First buffer of the new chunk
+    return chunks[current].data(); // Return the buffer
+}
+
+size_t Workspace::reserved() const { // Function to report the arena size
+    size_t total = 0; // Coefficients so far
+    for (const RingElement::Storage& chunk : chunks) total += chunk.size(); // Add every chunk
+    return total; // Return the total
+}
+
+Workspace& Workspace::thread_local_instance() { // Function to get this thread's workspace
+    thread_local Workspace workspace; // One per thread, kept for the life of the thread
+    return workspace; // Return it
+}
+
+}  // namespace lattice_crypto
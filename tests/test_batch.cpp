@@ -0,0 +1,95 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "lattice_crypto.h"
+#include "thread_pool.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// Hex form of a string, as returned by decrypt
+std::string to_hex(const std::string& input) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (unsigned char c : input) {
+        hex += digits[c >> 4];
+        hex += digits[c & 0x0f];
+    }
+    return hex;
+}
+
+int main() {
+    int failures = 0;
+    ThreadPool pool(4);
+
+    // Every index runs exactly once
+    std::vector<std::atomic<int>> hits(10000);
+    pool.parallel_for(hits.size(), [&](size_t i) { hits[i].fetch_add(1); });
+    bool once = true;
+    for (const auto& h : hits) once &= (h.load() == 1);
+    failures += check(once, "parallel_for covers every index once");
+
+    // Exceptions reach the caller after the range finishes
+    std::atomic<int> ran{0};
+    bool caught = false;
+    try {
+        pool.parallel_for(100, [&](size_t i) {
+            ran.fetch_add(1);
+            if (i == 37) throw std::runtime_error("task failed");
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    failures += check(caught && ran.load() == 100, "parallel_for rethrows task exceptions");
+
+    // Nested calls from a worker run inline instead of deadlocking
+    std::atomic<int> nested{0};
+    pool.parallel_for(8, [&](size_t) { pool.parallel_for(8, [&](size_t) { nested.fetch_add(1); }); });
+    failures += check(nested.load() == 64, "nested parallel_for runs inline");
+
+    // Batch round trip through the shared pool, with the keys shared by every worker
+    RingLWECrypto crypto(512, 12289);
+    std::vector<std::string> plaintexts;
+    for (int i = 0; i < 2000; ++i) plaintexts.push_back("wallet key #" + std::to_string(i));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Ciphertext> ciphertexts = crypto.encrypt_batch(plaintexts);
+    std::vector<std::string> decrypted = crypto.decrypt_batch(ciphertexts);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool round_trip = decrypted.size() == plaintexts.size();
+    for (size_t i = 0; round_trip && i < plaintexts.size(); ++i) round_trip &= (decrypted[i] == to_hex(plaintexts[i]));
+    failures += check(round_trip, "batch round trip of " + std::to_string(plaintexts.size()) + " messages on " +
+                                      std::to_string(ThreadPool::shared().size()) + " threads");
+    std::vector<std::string> raw = crypto.decrypt_batch_bytes(ciphertexts);
+    failures += check(raw == plaintexts, "batch round trip to raw bytes");
+    std::cout << "Batch throughput: " << plaintexts.size() / elapsed << " round trips/s" << std::endl;
+
+    // A forked child inherits started pools but none of their threads; its batches must still run
+    ThreadPool* parent_pool = &ThreadPool::shared();
+    pid_t child = ::fork();
+    if (child == 0) {
+        ::alarm(20);  // A hang kills the child instead of the test run
+        std::atomic<int> covered{0};
+        pool.parallel_for(1000, [&](size_t) { covered.fetch_add(1); });
+        std::vector<std::string> few(plaintexts.begin(), plaintexts.begin() + 64);
+        bool ok = covered.load() == 1000 && &ThreadPool::shared() != parent_pool &&
+                  crypto.decrypt_batch_bytes(crypto.encrypt_batch(few)) == few;
+        ::_exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    failures += check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "parallel_for and batches run in a forked child");
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " batch checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All batch checks passed." << std::endl;
+    return 0;
+}
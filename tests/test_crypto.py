@@ -9,10 +9,10 @@ import os
 sys.path.insert(0, os.path.abspath(os.path.join(os.path.dirname(__file__), '../src')))
 
 # Import the RingLWECrypto class from the lattice_crypto module
-from lattice_crypto import RingLWECrypto  # Correct import
+from lattice_crypto import RingLWECrypto, EncryptStream, DecryptStream  # Correct import
 
 # Initialize the crypto system with your desired parameters
-crypto = RingLWECrypto(512, 4096)
+crypto = RingLWECrypto(512, 12289)
 
 # Encrypt a sample message
 message = "Hello, World!"
@@ -21,10 +21,128 @@ encrypted_data = crypto.encrypt(message_bytes)
 print(f"Encrypted: {encrypted_data}")
 
 # Decrypt the message
-decrypted_data_bytes = crypto.decrypt(encrypted_data)
+decrypted_data_bytes = crypto.decrypt_bytes(encrypted_data)
 decrypted_data = decrypted_data_bytes.decode('utf-8')  # Convert bytes back to string
 print(f"Decrypted: {decrypted_data}")
 
 # Ensure the decrypted message matches the original
 assert decrypted_data == message, "Decryption failed: message does not match!"
 print("Decryption successful!")
+
+# Ciphertext coefficients are NumPy views over the C++ storage, not copies
+import numpy as np
+c1, c2 = encrypted_data
+view = np.asarray(c1)
+assert view.dtype == np.int32 and view.shape == (512,), "Unexpected coefficient view"
+assert view.ctypes.data == c1.numpy().ctypes.data, "Coefficient view is a copy"
+
+# NumPy arrays are accepted back as ciphertext
+assert crypto.decrypt_bytes((c1.numpy(), np.asarray(c2))) == message_bytes, "NumPy ciphertext failed to decrypt"
+
+# So are plain integer sequences
+assert crypto.decrypt_bytes((c1.to_list(), tuple(c2.to_list()))) == message_bytes, "List ciphertext failed to decrypt"
+
+# Batches of bytes-like messages round-trip through the thread pool
+messages = [f"wallet key {i}".encode('utf-8') for i in range(64)]
+assert crypto.decrypt_batch_bytes(crypto.encrypt_batch(messages)) == messages, "Batch round trip failed"
+print("NumPy views and batch round trip successful!")
+
+# Ciphertexts and keys serialize to the compact bit-packed format
+blob = crypto.to_bytes(encrypted_data)
+assert isinstance(blob, bytes) and len(blob) == 16 + 2 * 896, "Unexpected serialized ciphertext size"
+assert crypto.decrypt_bytes(crypto.from_bytes(blob)) == message_bytes, "Serialized ciphertext failed to decrypt"
+restored = RingLWECrypto.from_keys(crypto.public_key_bytes(), crypto.secret_key_bytes())
+assert restored.decrypt_bytes(crypto.encrypt(message_bytes)) == message_bytes, "Restored keys failed to decrypt"
+print("Serialization round trip successful!")
+
+# Keys saved to a keystore come back memory-mapped
+import tempfile
+with tempfile.TemporaryDirectory() as directory:
+    keystore = os.path.join(directory, 'lattice.keystore')
+    crypto.save_keystore(keystore)
+    mapped = RingLWECrypto.from_keystore(keystore)
+    assert mapped.decrypt_bytes(crypto.encrypt(message_bytes)) == message_bytes, "Mapped keys failed to decrypt"
+print("Keystore round trip successful!")
+
+# Binary payloads of any length stream through fixed-size blocks
+payload = os.urandom(100000) + b'\x00\xff'
+encryptor = EncryptStream(crypto)
+stream = b''.join(encryptor.update(payload[i:i + 4096]) for i in range(0, len(payload), 4096)) + encryptor.finalize()
+decryptor = DecryptStream(crypto)
+assert decryptor.update(stream) + decryptor.finalize() == payload, "Stream round trip failed"
+print("Stream round trip successful!")
+
+# Large payloads go through the hybrid mode: one lattice encapsulation, AES-256-GCM for the bytes
+backup = os.urandom(1 << 20)
+sealed = crypto.hybrid_encrypt(backup, b'wallet backup')
+assert crypto.hybrid_decrypt(sealed, b'wallet backup') == backup, "Hybrid round trip failed"
+try:
+    crypto.hybrid_decrypt(sealed, b'other context')
+    raise AssertionError("Hybrid decryption accepted the wrong associated data")
+except ValueError:
+    pass
+print("Hybrid round trip successful!")
+
+# Every encryption and decryption shows up in the metrics
+import lattice_crypto
+if lattice_crypto.metrics_enabled():
+    lattice_crypto.reset_metrics()
+    for _ in range(10):
+        crypto.decrypt_bytes(crypto.encrypt(message_bytes))
+    metrics = lattice_crypto.metrics_snapshot()
+    assert metrics['histograms']['encrypt']['count'] == 10, "Encryptions were not counted"
+    assert metrics['histograms']['decrypt']['count'] == 10, "Decryptions were not counted"
+    assert metrics['counters']['bytes_encrypted'] == 10 * len(message_bytes), "Encrypted bytes were not counted"
+    assert 'lattice_crypto_encrypt_seconds_count 10' in lattice_crypto.metrics_prometheus(), "Prometheus dump is missing encrypt"
+    print("Metrics snapshot successful!")
+
+# Precomputed randomness moves sampling and transforms off the encryption path
+crypto.enable_randomness_pool(depth=8, background=False)
+assert crypto.refill_randomness_pool() == 8 and crypto.randomness_pool_ready == 8, "Randomness pool did not fill"
+assert crypto.decrypt_bytes(crypto.encrypt(message_bytes)) == message_bytes, "Pooled encryption failed"
+assert crypto.randomness_pool_ready == 7, "Pooled encryption did not take an entry"
+crypto.disable_randomness_pool()
+assert crypto.randomness_pool_ready is None, "Randomness pool was not disabled"
+print("Randomness pool round trip successful!")
+
+# The daemon serves the same keys to every client; runs when creed_cryptod has been built
+import subprocess
+import time
+cryptod_binary = os.environ.get('CREED_CRYPTOD_BIN', os.path.join(os.path.dirname(__file__), '../build/creed_cryptod'))
+if os.path.exists(cryptod_binary):
+    from cryptod_client import CryptodClient, CryptodError, ENCRYPT
+    with tempfile.TemporaryDirectory() as directory:
+        keystore_path = os.path.join(directory, 'daemon.keystore')
+        socket_path = os.path.join(directory, 'cryptod.sock')
+        crypto.save_keystore(keystore_path)
+        daemon = subprocess.Popen([cryptod_binary, f'--keystore={keystore_path}', f'--socket={socket_path}',
+                                   f'--log={os.path.join(directory, "cryptod.log")}'])
+        try:
+            for _ in range(100):
+                if os.path.exists(socket_path):
+                    break
+                time.sleep(0.05)
+            with CryptodClient(socket_path, timeout=60) as client:  # A stalled pipeline fails instead of hanging
+                assert client.public_key() == crypto.public_key_bytes(), "Daemon loaded other keys"
+                sealed = client.encrypt(message_bytes)
+                assert crypto.decrypt_bytes(crypto.from_bytes(sealed)) == message_bytes, "Daemon encryption failed"
+                assert client.decrypt(sealed) == message_bytes, "Daemon decryption failed"
+                pipelined = client.pipeline([(ENCRYPT, b'%d' % i) for i in range(50)])
+                assert client.decrypt_batch(pipelined) == [b'%d' % i for i in range(50)], "Pipelined requests failed"
+                # Far more requests than the daemon keeps pending, answered with more than it buffers per client
+                long_run = [(ENCRYPT, b'%0200d' % i) for i in range(12000)]
+                assert client.decrypt_batch(client.pipeline(long_run)) == [p for _, p in long_run], "Long pipeline failed"
+                try:
+                    client.decrypt(b'not a ciphertext')
+                    raise AssertionError("Daemon accepted a malformed ciphertext")
+                except CryptodError:
+                    pass
+                try:
+                    client.encrypt(b'\x00abc')
+                    raise AssertionError("Daemon accepted a plaintext decryption would cut short")
+                except CryptodError:
+                    pass
+        finally:
+            daemon.terminate()
+            daemon.wait(timeout=10)
+    print("Crypto daemon round trip successful!")
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "crypto_log.h"
+#include "mpmc_queue.h"
+#include "polynomial.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// Producers and consumers hammering one queue; every value must come out exactly once
+int check_queue() {
+    MpmcQueue<uint64_t> queue(1024);
+    const uint64_t per_producer = 100000;
+    const int producers = 4, consumers = 2;
+    std::atomic<uint64_t> sum{0}, popped{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t i = 1; i <= per_producer; ++i) {
+                while (!queue.try_push(i + p * per_producer)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            uint64_t value;
+            while (popped.load() < producers * per_producer) {
+                if (queue.try_pop(value)) {
+                    sum.fetch_add(value);
+                    popped.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    const uint64_t n = producers * per_producer;
+    return check(sum.load() == n * (n + 1) / 2, "MPMC queue delivers every value once");
+}
+
+// Lines in a file
+std::vector<std::string> read_lines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) lines.push_back(line);
+    return lines;
+}
+
+int main() {
+    int failures = check_queue();
+    const std::string path = "test_crypto_log.txt";
+    std::remove(path.c_str());
+
+    // Nothing is formatted while no log is open
+    int evaluated = 0;
+    auto count = [&] { return ++evaluated; };
+    CRYPTO_LOG(error) << count();
+    failures += check(evaluated == 0, "no log open: operands not evaluated");
+
+    open_log(path);
+    set_log_level(LogLevel::debug);
+
+    // Records from many threads all arrive, none interleaved
+    const int threads = 8, per_thread = 400;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([t] {
+            for (int i = 0; i < per_thread; ++i) CRYPTO_LOG(debug) << "thread " << t << " record " << i;
+        });
+    }
+    for (std::thread& t : writers) t.join();
+
+    // Below the runtime level the operands are not evaluated
+    set_log_level(LogLevel::warn);
+    CRYPTO_LOG(info) << count();
+    failures += check(evaluated == 0, "below runtime level: operands not evaluated");
+
+    // Key material is redacted
+    RingElement secret(4);
+    for (size_t i = 0; i < secret.size(); ++i) secret[i] = 4321;
+    CRYPTO_LOG(warn) << "secret " << secret;
+
+    flush_log();
+    close_log();
+
+    std::vector<std::string> lines = read_lines(path);
+    size_t records = 0;
+    bool redacted = false, leaked = false;
+    for (const std::string& line : lines) {
+        if (line.find(" record ") != std::string::npos) ++records;
+        if (line.find("<ring element n=4, redacted>") != std::string::npos) redacted = true;
+        if (line.find("4321") != std::string::npos) leaked = true;
+    }
+    failures += check(records + dropped_log_records() == static_cast<size_t>(threads * per_thread),
+                      "concurrent records written or counted as dropped (" + std::to_string(dropped_log_records()) +
+                          " dropped)");
+    failures += check(redacted && !leaked, "ring elements are redacted");
+    std::remove(path.c_str());
+
+    // Records racing close_log land in the closing file or nowhere, never in the file opened next
+    const std::string next_path = "test_crypto_log_next.txt";
+    std::remove(next_path.c_str());
+    bool crossed = false;
+    for (int round = 0; round < 20 && !crossed; ++round) {
+        open_log(path);
+        set_log_level(LogLevel::debug);
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> racers;
+        for (int t = 0; t < 4; ++t) {
+            racers.emplace_back([&stop] {
+                while (!stop.load()) CRYPTO_LOG(debug) << "closing file record";
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        close_log();
+        stop.store(true);
+        for (std::thread& t : racers) t.join();
+        open_log(next_path);
+        CRYPTO_LOG(warn) << "next file record";
+        flush_log();
+        close_log();
+        for (const std::string& line : read_lines(next_path)) crossed |= line.find("closing file record") != std::string::npos;
+        std::remove(path.c_str());
+        std::remove(next_path.c_str());
+    }
+    failures += check(!crossed, "records racing close_log stay out of the next file");
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " logging checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All logging checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,353 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "cryptod_protocol.h"
+#include "cryptod_server.h"
+#include "lattice_crypto.h"
+#include "metrics.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// Blocking client connection, -1 when the connect fails
+int connect_to(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Reads frames off one connection
+struct Reader {
+    int fd;
+    std::string buffer;
+
+    // Reads the next frame into payload; false at end of stream
+    bool next(uint32_t& id, uint8_t& status, std::string& payload) {
+        while (true) {
+            CryptodFrame frame;
+            size_t used = parse_cryptod_frame(buffer, frame);
+            if (used != 0) {
+                id = frame.id;
+                status = frame.code;
+                payload.assign(frame.payload.data(), frame.payload.size());
+                buffer.erase(0, used);
+                return true;
+            }
+            char chunk[65536];
+            ssize_t got = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (got <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(got));
+        }
+    }
+};
+
+// Sends one request and waits for its response
+bool call(int fd, uint8_t opcode, const std::string& payload, uint8_t& status, std::string& response) {
+    std::string frame;
+    append_cryptod_frame(frame, 7, opcode, payload);
+    if (!send_all(fd, frame)) return false;
+    Reader reader{fd, {}};
+    uint32_t id;
+    return reader.next(id, status, response) && id == 7;
+}
+
+uint8_t op(CryptodOpcode opcode) { return static_cast<uint8_t>(opcode); }
+const uint8_t kOk = static_cast<uint8_t>(CryptodStatus::ok);
+const uint8_t kBadRequest = static_cast<uint8_t>(CryptodStatus::bad_request);
+
+int main() {
+    int failures = 0;
+    RingLWECrypto crypto(512, 12289);
+    const std::string path = "/tmp/test_cryptod_" + std::to_string(::getpid()) + ".sock";
+
+    // The frame codec round trips and rejects impossible lengths
+    std::string encoded;
+    append_cryptod_frame(encoded, 42, op(CryptodOpcode::encrypt), "abc");
+    CryptodFrame frame;
+    bool codec = parse_cryptod_frame(encoded.substr(0, 8), frame) == 0 && parse_cryptod_frame(encoded, frame) == encoded.size() &&
+                 frame.id == 42 && frame.code == op(CryptodOpcode::encrypt) && frame.payload == "abc";
+    std::string batch;
+    append_cryptod_batch(batch, {"", "one", std::string(300, 'x')});
+    std::vector<std::string_view> items = parse_cryptod_batch(batch);
+    codec &= batch.size() == cryptod_batch_size({"", "one", std::string(300, 'x')}) && items.size() == 3 && items[1] == "one" &&
+             items[2].size() == 300;
+    bool rejected = false;
+    try {
+        parse_cryptod_frame(std::string("\x01\0\0\0", 4), frame);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    try {
+        parse_cryptod_batch(batch.substr(0, batch.size() - 1));
+        rejected = false;
+    } catch (const std::invalid_argument&) {
+    }
+    failures += check(codec && rejected, "frame and batch codec");
+    bool unframeable = false;
+    try {
+        std::string header;
+        append_cryptod_header(header, 1, op(CryptodOpcode::encrypt_batch), size_t(1) << 32);
+    } catch (const std::invalid_argument&) {
+        unframeable = true;
+    }
+    failures += check(unframeable, "payload too large for the length field is refused, not truncated");
+
+    // Without XDG_RUNTIME_DIR the default socket sits in a directory private to this user, never in /tmp itself
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    const std::string saved_runtime = runtime ? runtime : "";
+    ::unsetenv("XDG_RUNTIME_DIR");
+    const std::string private_dir = "/tmp/creed-" + std::to_string(::geteuid());
+    struct stat dir_info;
+    bool private_default = default_cryptod_socket_path() == private_dir + "/creed_cryptod.sock" &&
+                           ::lstat(private_dir.c_str(), &dir_info) == 0 && S_ISDIR(dir_info.st_mode) &&
+                           dir_info.st_uid == ::geteuid() && (dir_info.st_mode & 0777) == 0700;
+    bool open_dir_rejected = false;
+    ::chmod(private_dir.c_str(), 0755);
+    try {
+        default_cryptod_socket_path();
+    } catch (const std::runtime_error&) {
+        open_dir_rejected = true;
+    }
+    ::chmod(private_dir.c_str(), 0700);
+    if (runtime) ::setenv("XDG_RUNTIME_DIR", saved_runtime.c_str(), 1);
+    failures += check(private_default && open_dir_rejected, "default socket directory is private to its owner");
+
+    // A small pending limit makes the pipelined bursts below run into backpressure
+    CryptodServerOptions options;
+    options.socket_path = path;
+    options.workers = 4;
+    options.max_pending = 16;
+    std::unique_ptr<CryptodServer> owned(new CryptodServer(crypto, options));
+    CryptodServer& server = *owned;
+    struct stat socket_file;
+    failures += check(::stat(path.c_str(), &socket_file) == 0 && S_ISSOCK(socket_file.st_mode) && (socket_file.st_mode & 0777) == 0600,
+                      "socket file is private to its owner");
+    std::thread loop([&] { server.run(); });
+
+    int fd = connect_to(path);
+    uint8_t status = 0;
+    std::string response;
+    failures += check(fd >= 0 && call(fd, op(CryptodOpcode::ping), "", status, response) && status == kOk && response.empty(), "ping");
+    failures += check(call(fd, op(CryptodOpcode::public_key), "", status, response) && status == kOk && response == crypto.public_key_bytes(),
+                      "public key matches the loaded keys");
+
+    // Pipelined requests are answered in order, and far fewer rounds run than requests
+    const int pipelined = 200;
+    std::string burst;
+    for (int i = 0; i < pipelined; ++i) append_cryptod_frame(burst, 1000 + i, op(CryptodOpcode::encrypt), "message " + std::to_string(i));
+    const uint64_t batches_before = server.stats().batches;
+    bool in_order = send_all(fd, burst);
+    std::vector<std::string> ciphertexts;
+    Reader reader{fd, {}};
+    for (int i = 0; i < pipelined && in_order; ++i) {
+        uint32_t id;
+        in_order = reader.next(id, status, response) && id == uint32_t(1000 + i) && status == kOk &&
+                   crypto.decrypt_bytes(crypto.ciphertext_from_bytes(response)) == "message " + std::to_string(i);
+        ciphertexts.push_back(response);
+    }
+    const uint64_t rounds = server.stats().batches - batches_before;
+    std::cout << pipelined << " pipelined encryptions ran in " << rounds << " rounds" << std::endl;
+    failures += check(in_order, "pipelined encryptions come back in order and decrypt");
+    failures += check(rounds < uint64_t(pipelined), "pipelined requests are batched");
+
+    burst.clear();
+    for (int i = 0; i < pipelined; ++i) append_cryptod_frame(burst, i, op(CryptodOpcode::decrypt), ciphertexts[i]);
+    in_order = send_all(fd, burst);
+    for (int i = 0; i < pipelined && in_order; ++i) {
+        uint32_t id;
+        in_order = reader.next(id, status, response) && id == uint32_t(i) && status == kOk && response == "message " + std::to_string(i);
+    }
+    failures += check(in_order, "pipelined decryptions return the plaintexts");
+
+    // Batch requests spread their items over the workers
+    std::vector<std::string> plaintexts;
+    for (int i = 0; i < 64; ++i) plaintexts.push_back(std::string(static_cast<size_t>(i % 20), char('a' + i % 26)));
+    std::string payload;
+    append_cryptod_batch(payload, plaintexts);
+    bool batched = call(fd, op(CryptodOpcode::encrypt_batch), payload, status, response) && status == kOk;
+    std::vector<std::string> sealed;
+    if (batched) for (std::string_view item : parse_cryptod_batch(response)) sealed.emplace_back(item);
+    payload.clear();
+    append_cryptod_batch(payload, sealed);
+    batched &= sealed.size() == plaintexts.size() && call(fd, op(CryptodOpcode::decrypt_batch), payload, status, response) && status == kOk;
+    std::vector<std::string> opened;
+    if (batched) for (std::string_view item : parse_cryptod_batch(response)) opened.emplace_back(item);
+    failures += check(batched && opened == plaintexts, "batch encryption and decryption");
+
+    // Every byte but the 0x00 and 0xff padding bytes round trips; plaintexts holding those are refused, not cut short
+    std::string bytes;
+    for (int b = 1; b < 0xff; ++b) bytes.push_back(static_cast<char>(b));
+    std::vector<std::string> binary;
+    for (size_t i = 0; i < bytes.size(); i += crypto.max_plaintext_size()) binary.push_back(bytes.substr(i, crypto.max_plaintext_size()));
+    payload.clear();
+    append_cryptod_batch(payload, binary);
+    bool binary_ok = call(fd, op(CryptodOpcode::encrypt_batch), payload, status, response) && status == kOk;
+    std::vector<std::string> binary_sealed;
+    if (binary_ok) for (std::string_view item : parse_cryptod_batch(response)) binary_sealed.emplace_back(item);
+    payload.clear();
+    append_cryptod_batch(payload, binary_sealed);
+    binary_ok &= call(fd, op(CryptodOpcode::decrypt_batch), payload, status, response) && status == kOk;
+    std::vector<std::string> binary_opened;
+    if (binary_ok) for (std::string_view item : parse_cryptod_batch(response)) binary_opened.emplace_back(item);
+    binary_ok &= binary_opened == binary;
+    binary_ok &= call(fd, op(CryptodOpcode::encrypt), std::string("\0abc", 4), status, response) && status == kBadRequest &&
+                 response.find("0x00") != std::string::npos;
+    payload.clear();
+    append_cryptod_batch(payload, {"abc", "ab\xff"});
+    binary_ok &= call(fd, op(CryptodOpcode::encrypt_batch), payload, status, response) && status == kBadRequest &&
+                 response.rfind("Item 1:", 0) == 0;
+    failures += check(binary_ok, "binary plaintexts round trip or are refused");
+
+    // Bad requests get an error response and leave the connection usable
+    bool errors = call(fd, 99, "", status, response) && status == kBadRequest && response.find("opcode") != std::string::npos;
+    errors &= call(fd, op(CryptodOpcode::decrypt), "not a ciphertext", status, response) && status == kBadRequest;
+    errors &= call(fd, op(CryptodOpcode::encrypt), std::string(crypto.max_plaintext_size() + 1, 'x'), status, response) && status == kBadRequest;
+    errors &= call(fd, op(CryptodOpcode::decrypt_batch), "\x05", status, response) && status == kBadRequest;
+    payload.clear();
+    append_cryptod_batch(payload, {sealed[0], "junk"});
+    errors &= call(fd, op(CryptodOpcode::decrypt_batch), payload, status, response) && status == kBadRequest &&
+              response.rfind("Item 1:", 0) == 0;
+    errors &= call(fd, op(CryptodOpcode::ping), "", status, response) && status == kOk;
+    failures += check(errors, "bad requests are answered with errors");
+
+    // Empty items cost four bytes each but answer with a whole ciphertext, so a batch is bounded by its answer
+    const size_t ciphertext_bytes = crypto.to_bytes(crypto.ciphertext_from_bytes(sealed[0])).size();
+    const size_t too_many = (kCryptodMaxFrameBytes - kCryptodHeaderBytes - 4) / (4 + ciphertext_bytes) + 1;
+    payload.clear();
+    append_cryptod_batch(payload, std::vector<std::string>(too_many));
+    bool bounded = call(fd, op(CryptodOpcode::encrypt_batch), payload, status, response) && status == kBadRequest &&
+                   response.find("frame limit") != std::string::npos;
+    payload.clear();
+    append_cryptod_batch(payload, std::vector<std::string>(too_many - 1, "a"));
+    bounded &= call(fd, op(CryptodOpcode::encrypt_batch), payload, status, response) && status == kOk &&
+               response.size() <= kCryptodMaxFrameBytes - kCryptodHeaderBytes;
+    failures += check(bounded, "batch whose answer would exceed the frame limit is refused");
+
+    if (metrics_enabled()) {
+        failures += check(call(fd, op(CryptodOpcode::metrics), "", status, response) && status == kOk &&
+                              response.find("lattice_crypto_encrypt_seconds_count") != std::string::npos,
+                          "metrics are served");
+    }
+    ::close(fd);
+
+    // A length that cannot be a frame closes the connection
+    fd = connect_to(path);
+    std::string oversized = std::string("\xff\xff\xff\x7f", 4) + std::string(5, '\0');
+    char byte;
+    failures += check(send_all(fd, oversized) && ::recv(fd, &byte, 1, 0) == 0, "invalid frame length closes the connection");
+    ::close(fd);
+
+    // A client that shuts down its side after writing still gets every response
+    fd = connect_to(path);
+    burst.clear();
+    for (int i = 0; i < 20; ++i) append_cryptod_frame(burst, i, op(CryptodOpcode::encrypt), "half closed");
+    send_all(fd, burst);
+    ::shutdown(fd, SHUT_WR);
+    Reader half{fd, {}};
+    int answered = 0;
+    uint32_t id;
+    while (half.next(id, status, response)) answered += status == kOk && id == uint32_t(answered);
+    failures += check(answered == 20, "half-closed client gets every response, then end of stream");
+    ::close(fd);
+
+    // Many clients pipelining at once
+    std::atomic<int> good{0};
+    std::vector<std::thread> clients;
+    for (int t = 0; t < 8; ++t) {
+        clients.emplace_back([&, t] {
+            int client = connect_to(path);
+            std::string requests;
+            for (int i = 0; i < 50; ++i) append_cryptod_frame(requests, i, op(CryptodOpcode::encrypt), "client " + std::to_string(t));
+            if (client < 0 || !send_all(client, requests)) return;
+            Reader responses{client, {}};
+            uint32_t rid;
+            uint8_t rstatus;
+            std::string body;
+            for (int i = 0; i < 50; ++i) {
+                if (!responses.next(rid, rstatus, body) || rid != uint32_t(i) || rstatus != kOk) break;
+                if (crypto.decrypt_bytes(crypto.ciphertext_from_bytes(body)) == "client " + std::to_string(t)) ++good;
+            }
+            ::close(client);
+        });
+    }
+    for (std::thread& client : clients) client.join();
+    failures += check(good.load() == 400, "concurrent pipelining clients");
+
+    // A second server cannot take over a live socket, nor replace a file that is not a socket
+    bool refused = false;
+    try {
+        CryptodServer second(crypto, options);
+    } catch (const std::runtime_error&) {
+        refused = true;
+    }
+    const std::string plain_file = path + ".txt";
+    ::close(::open(plain_file.c_str(), O_CREAT | O_WRONLY, 0600));
+    CryptodServerOptions wrong = options;
+    wrong.socket_path = plain_file;
+    try {
+        CryptodServer second(crypto, wrong);
+        refused = false;
+    } catch (const std::runtime_error&) {
+    }
+    ::unlink(plain_file.c_str());
+    failures += check(refused, "live socket and ordinary files are left alone");
+
+    // stop() ends run(), and the socket file goes away with the server
+    const CryptodServerStats stats = server.stats();
+    server.stop();
+    loop.join();
+    failures += check(stats.connections >= 11 && stats.requests >= 2 * pipelined + 400, "stats count connections and requests");
+    owned.reset();
+    failures += check(::access(path.c_str(), F_OK) != 0 && connect_to(path) < 0, "socket file removed on shutdown");
+
+    // A socket file left behind by a dead server is replaced
+    int dead = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    bool stale = ::bind(dead, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    ::close(dead);
+    {
+        CryptodServer restarted(crypto, options);
+        std::thread again([&] { restarted.run(); });
+        fd = connect_to(path);
+        stale &= fd >= 0 && call(fd, op(CryptodOpcode::ping), "", status, response) && status == kOk;
+        ::close(fd);
+        restarted.stop();
+        again.join();
+    }
+    failures += check(stale && ::access(path.c_str(), F_OK) != 0, "stale socket file replaced");
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " crypto daemon checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All crypto daemon checks passed." << std::endl;
+    return 0;
+}
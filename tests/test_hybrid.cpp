@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "hybrid.h"
+#include "lattice_crypto.h"
+#include "test_util.h"
+#include "workspace.h"
+
+using namespace lattice_crypto;
+
+// True when opening the message throws std::invalid_argument
+bool rejects(RingLWECrypto& crypto, const std::string& sealed, const std::string& associated_data = "") {
+    try {
+        hybrid_decrypt(crypto, sealed, associated_data);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    int failures = 0;
+    RingLWECrypto crypto(512, 12289);
+
+    // Round trips from empty to large payloads, binary content included
+    std::mt19937 rng(13);
+    bool round_trip = true;
+    for (size_t size : {size_t(0), size_t(1), size_t(255), size_t(4096), size_t(1 << 20)}) {
+        std::string payload(size, '\0');
+        for (char& c : payload) c = static_cast<char>(rng());
+        std::string sealed = hybrid_encrypt(crypto, payload);
+        round_trip &= sealed.size() == payload.size() + hybrid_overhead(crypto) && hybrid_decrypt(crypto, sealed) == payload;
+    }
+    failures += check(round_trip, "round trip from 0 bytes to 1 MiB");
+
+    // Neither r, e2 nor c1 * s is left in the thread's scratch, so the session key cannot be recovered from it
+    Workspace& workspace = Workspace::thread_local_instance();
+    {
+        Workspace::Scope scope(workspace);
+        const int32_t* scratch = workspace.take(Workspace::kChunkCoefficients);  // The chunk every operation above used
+        failures += check(std::all_of(scratch, scratch + Workspace::kChunkCoefficients, [](int32_t c) { return c == 0; }),
+                          "scratch is wiped after a round trip");
+    }
+    std::cout << "Overhead per message: " << hybrid_overhead(crypto) << " bytes" << std::endl;
+
+    // Throughput on a large payload is bounded by AES-GCM, not by the lattice
+    std::string backup(32 << 20, 'w');
+    auto start = std::chrono::steady_clock::now();
+    std::string sealed_backup = hybrid_encrypt(crypto, backup);
+    bool opened = hybrid_decrypt(crypto, sealed_backup) == backup;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    failures += check(opened, "32 MiB payload round trip");
+    std::cout << "Hybrid throughput: " << 2 * backup.size() / elapsed / (1 << 20) << " MiB/s (encrypt + decrypt)" << std::endl;
+
+    // Associated data is bound to the message
+    const std::string message = "transaction bundle", context = "wallet 0x01";
+    std::string sealed = hybrid_encrypt(crypto, message, context);
+    failures += check(hybrid_decrypt(crypto, sealed, context) == message, "associated data round trip");
+    failures += check(rejects(crypto, sealed, "wallet 0x02") && rejects(crypto, sealed), "wrong associated data rejected");
+
+    // Any change to the header, capsule, nonce, payload or tag is caught
+    bool tamper = true;
+    const size_t capsule_end = 12 + (hybrid_overhead(crypto) - 12 - 12 - 16);
+    for (size_t offset : {size_t(4), size_t(20), capsule_end - 1, capsule_end + 3, sealed.size() - 20, sealed.size() - 1}) {
+        std::string changed = sealed;
+        changed[offset] ^= 0x01;
+        tamper &= rejects(crypto, changed, context);
+    }
+    failures += check(tamper, "tampered messages rejected");
+    failures += check(rejects(crypto, sealed.substr(0, sealed.size() - 1), context), "truncated message rejected");
+
+    // A capsule cannot be opened with other keys or other parameters
+    RingLWECrypto stranger(512, 12289), other(1024, 12289);
+    failures += check(rejects(stranger, sealed, context), "other keys rejected");
+    failures += check(rejects(other, sealed, context), "other parameters rejected");
+
+    // Public-key-only senders can seal for the key owner
+    RingLWECrypto sender = RingLWECrypto::from_key_bytes(crypto.public_key_bytes());
+    failures += check(hybrid_decrypt(crypto, hybrid_encrypt(sender, message)) == message, "public-key sender round trip");
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " hybrid checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All hybrid checks passed." << std::endl;
+    return 0;
+}
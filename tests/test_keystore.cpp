@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "keystore.h"
+#include "lattice_crypto.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// Seconds spent in f
+template <class F>
+double seconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Contents of a file
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Replaces a file's contents
+void write_file(const std::string& path, const std::string& data) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+}
+
+// True when loading the keystore throws std::invalid_argument
+bool rejects(const std::string& path) {
+    try {
+        load_keystore(path);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    int failures = 0;
+    const std::string path = "test_keystore.bin", public_path = "test_keystore_public.bin", bad_path = "test_keystore_bad.bin";
+    const std::string message = "mapped wallet key";
+
+    std::unique_ptr<RingLWECrypto> generated;
+    double keygen = seconds([&] { generated.reset(new RingLWECrypto(512, 12289)); });
+    RingLWECrypto& crypto = *generated;
+    crypto.save_keystore(path);
+    crypto.save_keystore(public_path, false);
+
+    struct stat info;
+    failures += check(::stat(path.c_str(), &info) == 0 && (info.st_mode & 0777) == 0600, "keystore is private to its owner");
+    failures += check(info.st_size == static_cast<off_t>(kKeystoreHeaderBytes + 6 * 512 * sizeof(int32_t)),
+                      "keystore is " + std::to_string(info.st_size) + " bytes");
+
+    // Mapped keys decrypt what the generated ones encrypted, and the other way around
+    std::unique_ptr<RingLWECrypto> mapped;
+    double load = seconds([&] { mapped.reset(new RingLWECrypto(RingLWECrypto::from_keystore(path))); });
+    failures += check(mapped->decrypt_bytes(crypto.encrypt(message)) == message &&
+                          crypto.decrypt_bytes(mapped->encrypt(message)) == message,
+                      "mapped keys round trip");
+    failures += check(mapped->public_key_bytes() == crypto.public_key_bytes() &&
+                          mapped->secret_key_bytes() == crypto.secret_key_bytes(),
+                      "mapped keys match the saved ones");
+    std::cout << "Key generation: " << keygen * 1e6 << " us, keystore load: " << load * 1e6 << " us" << std::endl;
+
+    // The key arrays are used in place, on 64-byte boundaries
+    const RingKey& secret = mapped->engine().secret();
+    failures += check(reinterpret_cast<uintptr_t>(secret.data()) % 64 == 0 &&
+                          reinterpret_cast<uintptr_t>(secret.ntt_data(mapped->plan())) % 64 == 0,
+                      "mapped key arrays are 64-byte aligned");
+
+    // A key's NTT-domain form is refused under a plan for another modulus, whether mapped or cached on first use
+    NttPlan other_plan(512, 18433);
+    RingKey owned(RingElement(512));
+    owned.ntt_data(mapped->plan());
+    bool other_rejected = true;
+    for (const RingKey* key : {&secret, static_cast<const RingKey*>(&owned)}) {
+        try {
+            key->ntt_data(other_plan);
+            other_rejected = false;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    failures += check(other_rejected, "key refuses a plan with another modulus");
+
+    // A pre-forked worker decrypts through the mapping it inherited
+    Ciphertext ciphertext = crypto.encrypt(message);
+    pid_t child = ::fork();
+    if (child == 0) ::_exit(mapped->decrypt_bytes(ciphertext) == message ? 0 : 1);
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    failures += check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "forked worker decrypts with the shared mapping");
+
+    // A public keystore only encrypts
+    RingLWECrypto sender = RingLWECrypto::from_keystore(public_path);
+    bool encrypt_only = false;
+    try {
+        sender.decrypt_bytes(sender.encrypt(message));
+    } catch (const std::logic_error&) {
+        encrypt_only = true;
+    }
+    failures += check(encrypt_only && crypto.decrypt_bytes(sender.encrypt(message)) == message, "public keystore encrypts only");
+
+    // Malformed keystores are rejected
+    const std::string image = read_file(path);
+    write_file(bad_path, "XXXX" + image.substr(4));
+    failures += check(rejects(bad_path), "bad magic rejected");
+    write_file(bad_path, image.substr(0, image.size() - 4));
+    failures += check(rejects(bad_path), "truncated keystore rejected");
+    std::string out_of_range = image;
+    out_of_range[kKeystoreHeaderBytes + 3] = '\x7f';  // First coefficient of a far above q
+    write_file(bad_path, out_of_range);
+    failures += check(rejects(bad_path), "out-of-range coefficient rejected");
+    std::string stale_ntt = image;
+    int32_t first_ntt = 0;  // First entry of NTT(a); still in range after the change
+    std::memcpy(&first_ntt, stale_ntt.data() + kKeystoreHeaderBytes + 512 * sizeof(int32_t), sizeof(first_ntt));
+    first_ntt = (first_ntt + 1) % 12289;
+    std::memcpy(&stale_ntt[kKeystoreHeaderBytes + 512 * sizeof(int32_t)], &first_ntt, sizeof(first_ntt));
+    write_file(bad_path, stale_ntt);
+    failures += check(rejects(bad_path), "NTT form that disagrees with its coefficients rejected");
+    bool missing = false;
+    try {
+        RingLWECrypto::from_keystore("no_such_keystore.bin");
+    } catch (const std::runtime_error&) {
+        missing = true;
+    }
+    failures += check(missing, "missing keystore reported");
+
+    std::remove(path.c_str());
+    std::remove(public_path.c_str());
+    std::remove(bad_path.c_str());
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " keystore checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All keystore checks passed." << std::endl;
+    return 0;
+}
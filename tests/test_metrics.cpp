@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "lattice_crypto.h"
+#include "metrics.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+int main() {
+    int failures = 0;
+
+    // Buckets tile the value range without gaps, and every value lands in the bucket covering it
+    bool contiguous = histogram_bucket_lower(0) == 0;
+    for (size_t b = 0; b + 1 < kHistogramBuckets; ++b) contiguous &= histogram_bucket_upper(b) == histogram_bucket_lower(b + 1);
+    bool placed = true;
+    for (uint64_t value : {uint64_t(0), uint64_t(15), uint64_t(16), uint64_t(17), uint64_t(1000), uint64_t(123456789),
+                           (uint64_t(1) << 39) + 12345}) {
+        size_t b = histogram_bucket(value);
+        placed &= histogram_bucket_lower(b) <= value && value < histogram_bucket_upper(b);
+    }
+    bool precise = true;
+    for (size_t b = kHistogramSubBuckets; b + 1 < kHistogramBuckets; ++b) {
+        precise &= (histogram_bucket_upper(b) - histogram_bucket_lower(b)) * kHistogramSubBuckets <= histogram_bucket_lower(b);
+    }
+    failures += check(contiguous && placed && precise, "histogram buckets are contiguous and within 1/16 of their value");
+    failures += check(histogram_bucket(uint64_t(1) << 62) == kHistogramBuckets - 1, "long events share the last bucket");
+
+    if (!metrics_enabled()) {
+        std::cout << "Metrics are compiled out; nothing is recorded." << std::endl;
+        MetricsSnapshot snapshot = metrics_snapshot();
+        failures += check(snapshot.histogram(Histogram::encrypt).count == 0, "snapshot is empty");
+    } else {
+        // Operations are counted once each, across threads, including threads that have exited
+        RingLWECrypto crypto(512, 12289);
+        reset_metrics();
+        const std::string message = "metered wallet key";
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 25; ++i) crypto.decrypt_bytes(crypto.encrypt(message));
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        MetricsSnapshot snapshot = metrics_snapshot();
+        const HistogramSnapshot& encrypt = snapshot.histogram(Histogram::encrypt);
+        failures += check(encrypt.count == 100 && snapshot.histogram(Histogram::decrypt).count == 100,
+                          "100 encryptions and decryptions from exited threads");
+        failures += check(snapshot.counter(Counter::bytes_encrypted) == 100 * message.size() &&
+                              snapshot.counter(Counter::bytes_decrypted) == 100 * crypto.max_plaintext_size(),
+                          "bytes processed are counted");
+        // Each encryption runs three transforms and each decryption two
+        failures += check(snapshot.histogram(Histogram::ntt).count == 500, "every engine transform is timed");
+        failures += check(snapshot.histogram(Histogram::sampling).count >= 300 &&
+                              snapshot.counter(Counter::sampled_coefficients) >= 300 * 512,
+                          "sampler fills are timed and counted");
+        failures += check(snapshot.counter(Counter::allocations) > 0 && snapshot.counter(Counter::allocated_bytes) > 0,
+                          "ring element allocations are counted");
+        failures += check(encrypt.quantile_ns(0.5) > 0 && encrypt.quantile_ns(0.5) <= encrypt.quantile_ns(0.99) &&
+                              encrypt.mean_ns() > 0 && encrypt.max_ns >= encrypt.sum_ns / encrypt.count,
+                          "quantiles, mean and max are consistent");
+        std::cout << "Encrypt latency: p50 " << encrypt.quantile_ns(0.5) << " ns, p99 " << encrypt.quantile_ns(0.99)
+                  << " ns" << std::endl;
+
+        // A reset starts every metric from zero without touching the recording threads
+        reset_metrics();
+        crypto.encrypt(message);
+        snapshot = metrics_snapshot();
+        failures += check(snapshot.histogram(Histogram::encrypt).count == 1 &&
+                              snapshot.counter(Counter::bytes_encrypted) == message.size(),
+                          "reset starts from zero");
+
+        // The Prometheus dump carries every family with cumulative buckets
+        std::string text = metrics_prometheus();
+        failures += check(text.find("# TYPE lattice_crypto_encrypt_seconds histogram") != std::string::npos &&
+                              text.find("lattice_crypto_encrypt_seconds_count 1\n") != std::string::npos &&
+                              text.find("lattice_crypto_encrypt_seconds_bucket{le=\"+Inf\"} 1\n") != std::string::npos &&
+                              text.find("lattice_crypto_bytes_encrypted_total " + std::to_string(message.size()) + "\n") !=
+                                  std::string::npos,
+                          "Prometheus dump");
+
+        // Recording an event costs tens of nanoseconds, mostly the two clock reads
+        const int events = 1000000;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < events; ++i) {
+            CRYPTO_METRIC_TIMER(sampling);
+            CRYPTO_METRIC_COUNT(sampled_coefficients, 1);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / events;
+        std::cout << "Timed event with a counter: " << ns << " ns" << std::endl;
+    }
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " metrics checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All metrics checks passed." << std::endl;
+    return 0;
+}
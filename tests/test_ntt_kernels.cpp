@@ -0,0 +1,151 @@
+#include <iostream>
+#include <random>
+#include <vector>
+#include "ntt_kernels.h"
+#include "ntt_plan.h"
+#include "param_sets.h"
+#include "ring_lwe_fixed.h"
+
+using namespace lattice_crypto;
+
+// Random coefficients in [0, q)
+std::vector<int32_t> random_polynomial(std::mt19937& gen, int n, int q) {
+    std::uniform_int_distribution<int32_t> dist(0, q - 1);
+    std::vector<int32_t> values(n);
+    for (int32_t& x : values) x = dist(gen);
+    return values;
+}
+
+// Compares one SIMD kernel set against the scalar kernels for a given (n, q); returns the number of mismatches
+int check_kernels(const NttKernels& kernels, int n, int q, std::mt19937& gen) {
+    const NttKernels& scalar = *kernels_for(KernelIsa::scalar);
+    NttPlan scalar_plan(n, q, scalar);
+    NttPlan simd_plan(n, q, kernels);
+    int failures = 0;
+
+    for (int trial = 0; trial < 20; ++trial) {
+        std::vector<int32_t> a = random_polynomial(gen, n, q);
+        std::vector<int32_t> b = random_polynomial(gen, n, q);
+
+        // Forward transform
+        std::vector<int32_t> expected = a;
+        std::vector<int32_t> actual = a;
+        scalar_plan.forward(expected.data());
+        simd_plan.forward(actual.data());
+        if (expected != actual) ++failures;
+
+        // Pointwise product
+        std::vector<int32_t> expected_product(n), actual_product(n);
+        scalar_plan.pointwise(expected.data(), b.data(), expected_product.data());
+        simd_plan.pointwise(actual.data(), b.data(), actual_product.data());
+        if (expected_product != actual_product) ++failures;
+
+        // Inverse transform, which must also undo the forward transform
+        scalar_plan.inverse(expected.data());
+        simd_plan.inverse(actual.data());
+        if (expected != actual || actual != a) ++failures;
+    }
+
+    // Edge values: all coefficients at q - 1 stress the conditional subtractions
+    std::vector<int32_t> edge_expected(n, q - 1), edge_actual(n, q - 1);
+    scalar_plan.forward(edge_expected.data());
+    simd_plan.forward(edge_actual.data());
+    if (edge_expected != edge_actual) ++failures;
+
+    return failures;
+}
+
+// Compares the compile-time tables of P against the plan NttPlan builds at runtime; returns the number of mismatches
+template <class P>
+int check_tables(std::mt19937& gen) {
+    NttPlan runtime_plan(P::N, P::q);
+    NttPlan table_plan(NttTables<P>::view());
+    int failures = 0;
+    if (runtime_plan.root() != table_plan.root() || runtime_plan.inverse_n() != table_plan.inverse_n()) ++failures;
+
+    for (int trial = 0; trial < 5; ++trial) {
+        std::vector<int32_t> expected = random_polynomial(gen, P::N, P::q);
+        std::vector<int32_t> actual = expected;
+        runtime_plan.forward(expected.data());
+        table_plan.forward(actual.data());
+        if (expected != actual) ++failures;
+        runtime_plan.inverse(expected.data());
+        table_plan.inverse(actual.data());
+        if (expected != actual) ++failures;
+    }
+
+    std::cout << P::name << (failures == 0 ? ": constexpr tables match the runtime plan" : ": TABLE MISMATCH") << std::endl;
+    return failures;
+}
+
+// Compares the specialized scalar transforms RingLWE<P> runs without SIMD kernels against NttPlan over the same
+// tables, with the scalar and the active kernels; returns the number of mismatches
+template <class P>
+int check_fixed(std::mt19937& gen) {
+    NttPlan scalar_plan(NttTables<P>::view(), *kernels_for(KernelIsa::scalar));
+    NttPlan active_plan(NttTables<P>::view());
+    int failures = 0;
+
+    for (int trial = 0; trial < 20; ++trial) {
+        std::vector<int32_t> a = random_polynomial(gen, P::N, P::q);
+        std::vector<int32_t> b = random_polynomial(gen, P::N, P::q);
+        if (trial == 0) a.assign(P::N, P::q - 1);
+
+        std::vector<int32_t> fixed = a, scalar = a, active = a;
+        fixed_forward<P>(fixed.data());
+        scalar_plan.forward(scalar.data());
+        active_plan.forward(active.data());
+        if (fixed != scalar || fixed != active) ++failures;
+
+        std::vector<int32_t> fixed_product(P::N), plan_product(P::N);
+        fixed_pointwise<P>(fixed.data(), b.data(), fixed_product.data());
+        scalar_plan.pointwise(scalar.data(), b.data(), plan_product.data());
+        if (fixed_product != plan_product) ++failures;
+
+        fixed_inverse<P>(fixed_product.data());
+        scalar_plan.inverse(plan_product.data());
+        if (fixed_product != plan_product) ++failures;
+        fixed_inverse<P>(fixed.data());
+        if (fixed != a) ++failures;
+    }
+
+    std::cout << P::name << (failures == 0 ? ": fixed scalar path is bit-identical to the plan" : ": FIXED PATH MISMATCH") << std::endl;
+    return failures;
+}
+
+int main() {
+    std::mt19937 gen(12345);
+    // The small rings cover transforms shorter than, equal to and just above one SIMD register
+    const std::pair<int, int> parameter_sets[] = {{8, 17}, {16, 97}, {32, 193}, {256, 7681}, {512, 12289}, {1024, 12289}};
+    int failures = 0;
+
+    std::cout << "Active kernels: " << active_kernels().name << std::endl;
+
+    for (KernelIsa isa : {KernelIsa::scalar, KernelIsa::avx2, KernelIsa::avx512}) {
+        const NttKernels* kernels = kernels_for(isa);
+        if (kernels == nullptr) {
+            std::cout << "Skipping kernels not supported on this machine." << std::endl;
+            continue;
+        }
+        for (const auto& params : parameter_sets) {
+            int mismatches = check_kernels(*kernels, params.first, params.second, gen);
+            std::cout << kernels->name << " n=" << params.first << " q=" << params.second
+                      << (mismatches == 0 ? ": bit-identical to scalar" : ": MISMATCH") << std::endl;
+            failures += mismatches;
+        }
+    }
+
+    failures += check_tables<Params256>(gen);
+    failures += check_tables<Params512>(gen);
+    failures += check_tables<Params1024>(gen);
+    failures += check_fixed<Params256>(gen);
+    failures += check_fixed<Params512>(gen);
+    failures += check_fixed<Params1024>(gen);
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " kernel mismatches." << std::endl;
+        return 1;
+    }
+    std::cout << "All kernels match the scalar path." << std::endl;
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "lattice_crypto.h"
+#include "metrics.h"
+#include "randomness_pool.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// Waits up to two seconds for the pool to hold at least count entries
+bool wait_until_ready(const RandomnessPool& pool, size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (pool.ready() < count) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Median wall time of one encrypt_into call, in nanoseconds
+double median_encrypt_ns(RingLWECrypto& crypto, const std::string& message, int rounds) {
+    Ciphertext ciphertext;
+    std::vector<double> times;
+    for (int i = 0; i < rounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        crypto.encrypt_into(message, ciphertext);
+        times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main() {
+    int failures = 0;
+    RingLWECrypto crypto(512, 12289);
+    const std::string message = "signing-time transaction";
+
+    // A foreground pool only fills when asked, and every entry decrypts correctly
+    RandomnessPoolOptions manual;
+    manual.depth = 16;
+    manual.background = false;
+    crypto.enable_randomness_pool(manual);
+    std::shared_ptr<RandomnessPool> pool = crypto.randomness_pool();
+    failures += check(pool && pool->ready() == 0 && pool->refill() == 16 && pool->ready() == 16, "refill fills to the depth");
+    bool round_trip = true;
+    std::vector<Ciphertext> seen;
+    for (int i = 0; i < 16; ++i) {
+        Ciphertext ciphertext = crypto.encrypt(message);
+        round_trip &= crypto.decrypt_bytes(ciphertext) == message;
+        for (const Ciphertext& other : seen) round_trip &= other.first != ciphertext.first;
+        seen.push_back(ciphertext);
+    }
+    failures += check(round_trip && pool->ready() == 0, "every entry decrypts and is used once");
+
+    // An empty pool falls back to full encryption
+    failures += check(crypto.decrypt_bytes(crypto.encrypt(message)) == message && pool->ready() == 0, "empty pool falls back");
+
+    // Oversized plaintexts are rejected without spending an entry
+    pool->refill();
+    bool rejected = false;
+    try {
+        crypto.encrypt(std::string(crypto.max_plaintext_size() + 1, 'x'));
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    failures += check(rejected && pool->ready() == 16, "oversized plaintext rejected before taking an entry");
+
+    // Hits are counted apart from misses
+    if (metrics_enabled()) {
+        reset_metrics();
+        for (int i = 0; i < 20; ++i) crypto.encrypt(message);
+        MetricsSnapshot snapshot = metrics_snapshot();
+        failures += check(snapshot.counter(Counter::pool_hits) == 16 && snapshot.counter(Counter::pool_misses) == 4,
+                          "pool hits and misses are counted");
+    }
+
+    // A hit only encodes the message, so it is far cheaper than a full encryption
+    pool->refill();
+    double hit_ns = median_encrypt_ns(crypto, message, 15);
+    crypto.disable_randomness_pool();
+    double full_ns = median_encrypt_ns(crypto, message, 15);
+    std::cout << "Median encrypt: " << hit_ns << " ns from the pool, " << full_ns << " ns without" << std::endl;
+    failures += check(hit_ns < full_ns, "pool hit is faster than a full encryption");
+    failures += check(crypto.randomness_pool() == nullptr && pool.use_count() == 1, "disable releases the pool");
+    pool.reset();
+
+    // The background thread tops the pool up as it drains, while many threads encrypt
+    RandomnessPoolOptions background;
+    background.depth = 64;
+    background.refill_below = 48;
+    crypto.enable_randomness_pool(background);
+    pool = crypto.randomness_pool();
+    failures += check(wait_until_ready(*pool, 64), "background thread fills the pool");
+    std::atomic<bool> concurrent{true};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            Ciphertext ciphertext;
+            std::string plaintext;
+            for (int i = 0; i < 100; ++i) {
+                crypto.encrypt_into(message, ciphertext);
+                crypto.decrypt_into(ciphertext, plaintext);
+                if (plaintext != message) concurrent = false;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    failures += check(concurrent.load(), "concurrent encryptions through the pool round trip");
+    failures += check(wait_until_ready(*pool, 64), "background thread refills after a burst");
+
+    // A forked child never takes the entries it inherited, since the parent may use the same ones. Like a pre-forked
+    // worker it then starts its own pool, dropping the inherited one, and exits through main so every destructor runs.
+    pid_t child = ::fork();
+    if (child == 0) {
+        ::alarm(10);  // A hang on the parent's refill thread fails the check instead of the whole run
+        const size_t before = pool->ready();
+        bool ok = crypto.decrypt_bytes(crypto.encrypt(message)) == message && pool->ready() == before && pool->refill() == 0;
+        pool.reset();
+        crypto.enable_randomness_pool(background);
+        ok = ok && wait_until_ready(*crypto.randomness_pool(), 64) && crypto.decrypt_bytes(crypto.encrypt(message)) == message;
+        crypto.disable_randomness_pool();
+        return ok ? 0 : 1;
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    failures += check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "forked child replaces the inherited pool without reusing it");
+
+    // Replacing a running pool while other threads encrypt is safe
+    std::atomic<bool> running{true};
+    std::thread encryptor([&] {
+        while (running.load()) {
+            if (crypto.decrypt_bytes(crypto.encrypt(message)) != message) concurrent = false;
+        }
+    });
+    for (int i = 0; i < 5; ++i) {
+        crypto.enable_randomness_pool(background);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        crypto.disable_randomness_pool();
+    }
+    running = false;
+    encryptor.join();
+    failures += check(concurrent.load(), "pool swapped under a running encryptor");
+
+    bool bad_depth = false;
+    try {
+        RandomnessPoolOptions empty;
+        empty.depth = 0;
+        crypto.enable_randomness_pool(empty);
+    } catch (const std::invalid_argument&) {
+        bad_depth = true;
+    }
+    failures += check(bad_depth, "zero depth rejected");
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " randomness pool checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All randomness pool checks passed." << std::endl;
+    return 0;
+}
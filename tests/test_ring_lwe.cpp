@@ -1,37 +1,9 @@
 #include <iostream>
-#include <fstream>
 #include <sstream>
 #include <iomanip>
-#include <filesystem>
+#include "crypto_log.h"  // For init_logging and close_log
 #include "lattice_crypto.h"  // Include the lattice crypto header for RingLWECrypto
 
-namespace fs = std::filesystem;
-
-// Initialize logging mechanism
-std::ofstream log_file;
-
-void init_logging() {
-    // Ensure the logs directory exists
-    try {
-        if (!fs::create_directories("logs")) {
-            std::cerr << "Log directory already exists or failed to create." << std::endl;
-        }
-    } catch (const fs::filesystem_error& e) {
-        std::cerr << "Filesystem error: " << e.what() << std::endl;
-        exit(EXIT_FAILURE);  // Exit if the log directory can't be created
-    }
-
-    // Open the log file for writing
-    log_file.open("logs/crypto_log.txt", std::ios::out | std::ios::app);  // Open in append mode
-    if (!log_file.is_open()) {
-        std::cerr << "Failed to open log file." << std::endl;
-        exit(EXIT_FAILURE);  // Exit if the log file can't be opened
-    }
-
-    log_file << "Logging initialized." << std::endl;
-    log_file.flush();  // Flush the log file to ensure the entry is written
-}
-
 // Function to convert a string into its hex representation
 std::string to_hex(const std::string& input) {
     std::stringstream hex_stream;
@@ -43,11 +15,12 @@ std::string to_hex(const std::string& input) {
 
 int main() {
     // Initialize logging
-    init_logging();
+    lattice_crypto::init_logging();
+    int status = 0;
 
     // Initialize the RingLWECrypto system with polynomial degree and modulus
     int poly_degree = 512;  // Example polynomial degree
-    int modulus = 2048;     // Example modulus (q)
+    int modulus = 12289;    // Example modulus (q), NTT-friendly for n = 512
 
     // Instantiate the RingLWECrypto object
     lattice_crypto::RingLWECrypto ringLWE(poly_degree, modulus);
@@ -70,18 +43,18 @@ int main() {
             std::cout << "Encryption/Decryption successful! Decrypted text matches the original." << std::endl;
         } else {
             std::cout << "Error: Decrypted text does not match the original." << std::endl;
+            status = 1;
             std::cout << "Original: " << plaintext_hex << std::endl;
             std::cout << "Decrypted: " << decrypted_text << std::endl;
         }
 
     } catch (const std::exception& e) {
         std::cerr << "An error occurred during encryption/decryption: " << e.what() << std::endl;
+        status = 1;
     }
 
     // Close the log file when done
-    if (log_file.is_open()) {
-        log_file.close();
-    }
+    lattice_crypto::close_log();
 
-    return 0;
+    return status;
 }
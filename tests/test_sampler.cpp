@@ -0,0 +1,92 @@
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "sampler.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// Mean of the values
+double mean(const std::vector<int32_t>& values) {
+    double sum = 0;
+    for (int32_t x : values) sum += x;
+    return sum / values.size();
+}
+
+// Variance of the values
+double variance(const std::vector<int32_t>& values) {
+    double m = mean(values);
+    double sum = 0;
+    for (int32_t x : values) sum += (x - m) * (x - m);
+    return sum / values.size();
+}
+
+int main() {
+    const size_t count = 1 << 16;
+    const int q = 12289;
+    int failures = 0;
+
+    // The seeded keystream is reproducible, and different seeds give different streams
+    std::array<uint8_t, 32> seed{};
+    seed[0] = 1;
+    Sampler first(seed), second(seed);
+    std::vector<int32_t> a(count), b(count);
+    first.fill_uniform(a.data(), count, q);
+    second.fill_uniform(b.data(), count, q);
+    failures += check(a == b, "same seed gives the same stream");
+    seed[0] = 2;
+    Sampler other(seed);
+    other.fill_uniform(b.data(), count, q);
+    failures += check(a != b, "different seeds give different streams");
+
+    // Each distribution lands in range with the expected moments, for both sources
+    for (Sampler* sampler : {&first, &Sampler::thread_local_instance()}) {
+        const std::string source = sampler->source() == SamplerSource::system ? "system" : "aes_ctr";
+        std::vector<int32_t> values(count);
+
+        sampler->fill_uniform(values.data(), count, q);
+        bool in_range = true;
+        for (int32_t x : values) in_range &= (x >= 0 && x < q);
+        failures += check(in_range && std::fabs(mean(values) - (q - 1) / 2.0) < q * 0.01, source + " uniform mod q");
+
+        sampler->fill_binary(values.data(), count);
+        in_range = true;
+        for (int32_t x : values) in_range &= (x == 0 || x == 1);
+        failures += check(in_range && std::fabs(mean(values) - 0.5) < 0.01, source + " binary");
+
+        sampler->fill_centered_binomial(values.data(), count, 5);
+        in_range = true;
+        for (int32_t x : values) in_range &= (x >= -5 && x <= 5);
+        failures += check(in_range && std::fabs(mean(values)) < 0.05 && std::fabs(variance(values) - 2.5) < 0.1,
+                          source + " centered binomial, eta = 5");
+    }
+
+    // A forked child drops the bytes its thread's sampler buffered in the parent, so both draw different randomness
+    uint8_t parent_bytes[32], child_bytes[32] = {};
+    Sampler::thread_local_instance().fill_bytes(parent_bytes, 1);  // The block now holds unread bytes
+    int pipe_fds[2];
+    bool piped = ::pipe(pipe_fds) == 0;
+    pid_t child = piped ? ::fork() : -1;
+    if (child == 0) {
+        Sampler::thread_local_instance().fill_bytes(child_bytes, sizeof(child_bytes));
+        ::_exit(::write(pipe_fds[1], child_bytes, sizeof(child_bytes)) == sizeof(child_bytes) ? 0 : 1);
+    }
+    Sampler::thread_local_instance().fill_bytes(parent_bytes, sizeof(parent_bytes));
+    bool received = child > 0 && ::read(pipe_fds[0], child_bytes, sizeof(child_bytes)) == sizeof(child_bytes);
+    int status = 0;
+    if (child > 0) ::waitpid(child, &status, 0);
+    failures += check(received && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                          std::memcmp(parent_bytes, child_bytes, sizeof(parent_bytes)) != 0,
+                      "forked child does not replay the parent's buffered bytes");
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " sampler checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All sampler checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "lattice_crypto.h"
+#include "serialization.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// True when parsing the blob throws std::invalid_argument
+bool rejects(const std::string& blob, BlobType type) {
+    try {
+        deserialize_polynomials(blob, type);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    int failures = 0;
+    std::mt19937 rng(7);
+
+    // Pack and unpack at every width, including lengths that leave a partial word or byte at the end
+    bool packed = true;
+    for (int bits = 1; bits <= 16; ++bits) {
+        for (size_t n : {1, 3, 7, 64, 255, 512}) {
+            std::vector<int32_t> in(n), out(n, -1);
+            for (int32_t& c : in) c = static_cast<int32_t>(rng() & ((1u << bits) - 1));
+            std::vector<uint8_t> bytes(packed_size(n, bits) + 1, 0xa5);  // Trailing canary
+            pack_coefficients(in.data(), n, bits, bytes.data());
+            unpack_coefficients(bytes.data(), n, bits, out.data());
+            packed &= (in == out) && bytes.back() == 0xa5;
+        }
+    }
+    failures += check(packed, "pack/unpack round trip at 1..16 bits");
+    failures += check(coefficient_bits(12289) == 14 && coefficient_bits(7681) == 13 && coefficient_bits(4096) == 12,
+                      "coefficient widths");
+
+    // Ciphertext round trip and size
+    RingLWECrypto crypto(512, 12289);
+    const std::string message = "serialized wallet key";
+    std::string blob = crypto.to_bytes(crypto.encrypt(message));
+    failures += check(blob.size() == kSerializedHeaderBytes + 2 * 896, "ciphertext is " + std::to_string(blob.size()) + " bytes");
+    failures += check(crypto.decrypt_bytes(crypto.ciphertext_from_bytes(blob)) == message, "ciphertext round trip");
+
+    // Malformed input is rejected
+    std::string bad_magic = blob, bad_version = blob, bad_coefficient = blob;
+    bad_magic[0] = 'X';
+    bad_version[4] = 2;
+    for (size_t i = kSerializedHeaderBytes; i < kSerializedHeaderBytes + 4; ++i) bad_coefficient[i] = '\xff';  // 14 set bits >= q
+    failures += check(rejects(bad_magic, BlobType::ciphertext), "bad magic rejected");
+    failures += check(rejects(bad_version, BlobType::ciphertext), "bad version rejected");
+    failures += check(rejects(blob.substr(0, blob.size() - 1), BlobType::ciphertext), "truncated blob rejected");
+    failures += check(rejects(blob + '\0', BlobType::ciphertext), "overlong blob rejected");
+    failures += check(rejects(blob, BlobType::public_key), "wrong blob type rejected");
+    failures += check(rejects(bad_coefficient, BlobType::ciphertext), "out-of-range coefficient rejected");
+    bool wrong_params = false;
+    try {
+        RingLWECrypto(1024, 12289).ciphertext_from_bytes(blob);
+    } catch (const std::invalid_argument&) {
+        wrong_params = true;
+    }
+    failures += check(wrong_params, "ciphertext for other parameters rejected");
+
+    // Keys exported from one instance work in another
+    RingLWECrypto restored = RingLWECrypto::from_key_bytes(crypto.public_key_bytes(), crypto.secret_key_bytes());
+    failures += check(restored.decrypt_bytes(crypto.encrypt(message)) == message &&
+                          crypto.decrypt_bytes(restored.encrypt(message)) == message,
+                      "key export/import round trip");
+
+    // A public key alone gives an encrypt-only instance
+    RingLWECrypto sender = RingLWECrypto::from_key_bytes(crypto.public_key_bytes());
+    bool encrypt_only = false;
+    try {
+        sender.decrypt_bytes(sender.encrypt(message));
+    } catch (const std::logic_error&) {
+        encrypt_only = true;
+    }
+    failures += check(encrypt_only && crypto.decrypt_bytes(sender.encrypt(message)) == message, "public-key-only instance encrypts");
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " serialization checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All serialization checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "lattice_crypto.h"
+#include "stream.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// Encrypts plaintext as a stream fed in chunks of the given size
+std::string encrypt_stream(RingLWECrypto& crypto, const std::string& plaintext, size_t chunk) {
+    EncryptStream stream(crypto);
+    std::string out;
+    for (size_t i = 0; i < plaintext.size(); i += chunk) stream.update(std::string_view(plaintext).substr(i, chunk), out);
+    stream.finalize(out);
+    return out;
+}
+
+// Decrypts a ciphertext stream fed in chunks of the given size
+std::string decrypt_stream(RingLWECrypto& crypto, const std::string& ciphertext, size_t chunk) {
+    DecryptStream stream(crypto);
+    std::string out;
+    for (size_t i = 0; i < ciphertext.size(); i += chunk) stream.update(std::string_view(ciphertext).substr(i, chunk), out);
+    stream.finalize(out);
+    return out;
+}
+
+// True when decrypting the stream throws std::invalid_argument
+bool rejects(RingLWECrypto& crypto, const std::string& ciphertext) {
+    try {
+        decrypt_stream(crypto, ciphertext, 4096);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    int failures = 0;
+    RingLWECrypto crypto(512, 12289);
+    EncryptStream probe(crypto);
+    const size_t payload = probe.payload_size(), block = probe.block_size();
+
+    // Binary data, including the 0x00 and 0xff bytes decrypt_bytes treats as padding
+    std::mt19937 rng(11);
+    std::string binary(3 * 1024 * 1024 + 17, '\0');
+    for (char& c : binary) c = static_cast<char>(rng());
+    binary[0] = '\0';
+    binary[1] = '\xff';
+
+    auto start = std::chrono::steady_clock::now();
+    std::string ciphertext = encrypt_stream(crypto, binary, 65536);
+    std::string decrypted = decrypt_stream(crypto, ciphertext, 65536);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    failures += check(decrypted == binary, "3 MiB binary round trip");
+    failures += check(ciphertext.size() == (binary.size() / payload + 1) * block, "one block per " + std::to_string(payload) + " bytes");
+    std::cout << "Stream throughput: " << 2 * binary.size() / elapsed / (1 << 20) << " MiB/s (encrypt + decrypt)" << std::endl;
+
+    // Chunk boundaries do not matter
+    const std::string text = binary.substr(0, 10 * payload + 5);
+    bool chunked = true;
+    for (size_t chunk : {size_t(1), size_t(7), payload, payload + 1, block - 1, size_t(100000)}) {
+        chunked &= decrypt_stream(crypto, encrypt_stream(crypto, text, chunk), chunk) == text;
+    }
+    failures += check(chunked, "round trip with odd chunk sizes");
+
+    // Edge lengths
+    failures += check(decrypt_stream(crypto, encrypt_stream(crypto, "", 1), 1).empty() &&
+                          encrypt_stream(crypto, "", 1).size() == block,
+                      "empty payload is one final block");
+    const std::string exact = binary.substr(0, kStreamBatchBlocks * payload);
+    failures += check(decrypt_stream(crypto, encrypt_stream(crypto, exact, 4096), 4096) == exact, "payload of exactly one batch");
+
+    // Truncated, extended and reordered streams are rejected
+    const std::string short_stream = encrypt_stream(crypto, text, 4096);
+    failures += check(rejects(crypto, short_stream.substr(0, short_stream.size() - 1)), "stream cut inside a block rejected");
+    failures += check(rejects(crypto, short_stream.substr(0, short_stream.size() - block)), "stream without final block rejected");
+    failures += check(rejects(crypto, short_stream + short_stream.substr(0, block)), "data after the final block rejected");
+    failures += check(rejects(crypto, short_stream.substr(short_stream.size() - block) + short_stream), "final block first rejected");
+
+    // Blocks are bound to their position and to their stream
+    std::string swapped = short_stream;
+    swapped.replace(0, block, short_stream, block, block);
+    swapped.replace(block, block, short_stream, 0, block);
+    failures += check(rejects(crypto, swapped), "swapped blocks rejected");
+    failures += check(rejects(crypto, short_stream.substr(0, block) + short_stream), "repeated block rejected");
+    failures += check(rejects(crypto, short_stream.substr(0, block) + short_stream.substr(2 * block)), "dropped block rejected");
+    std::string spliced = short_stream;
+    spliced.replace(block, block, encrypt_stream(crypto, text, 4096), block, block);
+    failures += check(rejects(crypto, spliced), "block from another stream rejected");
+
+    // The stream is bound to its parameter set
+    RingLWECrypto other(1024, 12289);
+    failures += check(rejects(other, short_stream), "stream for other parameters rejected");
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " stream checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All stream checks passed." << std::endl;
+    return 0;
+}
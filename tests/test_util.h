@@ -0,0 +1,15 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <iostream>
+#include <string>
+
+// Helpers shared by the standalone test executables
+
+// Reports one check and returns 1 when it failed
+inline int check(bool ok, const std::string& what) {
+    std::cout << what << (ok ? ": ok" : ": FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
+
+#endif  // TEST_UTIL_H
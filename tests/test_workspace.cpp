@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include "lattice_crypto.h"
+#include "workspace.h"
+#include "test_util.h"
+
+using namespace lattice_crypto;
+
+// Every C++ heap allocation in this process goes through the replacements below and is counted
+static std::atomic<size_t> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Heap allocations made by rounds of encrypt_into + decrypt_into after one warm-up round
+size_t steady_state_allocations(RingLWECrypto& crypto, int rounds, bool& round_trip) {
+    const std::string message = "steady-state wallet key";
+    Ciphertext ciphertext;
+    std::string plaintext;
+    crypto.encrypt_into(message, ciphertext);  // Sizes the outputs and the thread's workspace and sampler
+    crypto.decrypt_into(ciphertext, plaintext);
+    const size_t before = allocations.load();
+    round_trip = true;
+    for (int i = 0; i < rounds; ++i) {
+        crypto.encrypt_into(message, ciphertext);
+        crypto.decrypt_into(ciphertext, plaintext);
+        round_trip &= plaintext == message;
+    }
+    return allocations.load() - before;
+}
+
+int main() {
+    int failures = 0;
+
+    // Scratch is aligned, reused across scopes and released when a scope ends
+    Workspace workspace;
+    int32_t* first = nullptr;
+    {
+        Workspace::Scope scope(workspace);
+        first = workspace.take(5);
+        int32_t* second = workspace.take(512);
+        failures += check(reinterpret_cast<uintptr_t>(first) % 64 == 0 && reinterpret_cast<uintptr_t>(second) % 64 == 0,
+                          "workspace buffers are 64-byte aligned");
+        {
+            Workspace::Scope nested(workspace);
+            workspace.take(Workspace::kChunkCoefficients);  // Spills into a second chunk
+        }
+        failures += check(workspace.take(16) == second + 512, "nested scope releases its buffers");
+    }
+    const size_t reserved = workspace.reserved();
+    {
+        Workspace::Scope scope(workspace);
+        failures += check(workspace.take(5) == first, "scope end rewinds the workspace");
+        workspace.take(Workspace::kChunkCoefficients);
+    }
+    failures += check(workspace.reserved() == reserved, "chunks are kept and reused");
+
+    // A wiping scope cleanses everything it took, across chunks, and leaves buffers taken before it alone
+    Workspace secrets;
+    {
+        Workspace::Scope outer(secrets);
+        int32_t* kept = secrets.take(16);
+        std::fill(kept, kept + 16, 7);
+        int32_t* secret = nullptr;
+        int32_t* spilled = nullptr;
+        {
+            Workspace::Scope scope(secrets, Workspace::Release::wipe);
+            secret = secrets.take(64);
+            std::fill(secret, secret + 64, 5);
+            spilled = secrets.take(Workspace::kChunkCoefficients);  // Spills into a second chunk
+            std::fill(spilled, spilled + Workspace::kChunkCoefficients, 5);
+        }
+        auto all = [](const int32_t* p, size_t count, int32_t value) { return std::all_of(p, p + count, [&](int32_t c) { return c == value; }); };
+        failures += check(all(kept, 16, 7) && all(secret, 64, 0) && all(spilled, Workspace::kChunkCoefficients, 0),
+                          "wiping scope cleanses its buffers on release");
+    }
+
+    // Steady-state encryption and decryption allocate nothing, on the specialized scalar loops and on every SIMD kernel set
+    for (KernelIsa isa : {KernelIsa::scalar, KernelIsa::avx2, KernelIsa::avx512}) {
+        const NttKernels* kernels = kernels_for(isa);
+        if (kernels == nullptr) continue;  // Not built in or not supported by this CPU
+        for (int n : {256, 512, 1024}) {
+            RingLWECrypto crypto(n, n == 256 ? 7681 : 12289, *kernels);
+            bool round_trip = false;
+            size_t count = steady_state_allocations(crypto, 1000, round_trip);
+            failures += check(round_trip && count == 0, std::string(kernels->name) + ", n = " + std::to_string(n) + ": 1000 round trips, " +
+                                                            std::to_string(count) + " heap allocations");
+        }
+    }
+
+    if (failures != 0) {
+        std::cout << "Error: " << failures << " workspace checks failed." << std::endl;
+        return 1;
+    }
+    std::cout << "All workspace checks passed." << std::endl;
+    return 0;
+}